@@ -0,0 +1,171 @@
+#ifndef ANALYZER_HH__
+#define ANALYZER_HH__
+
+#include "Board.hh"
+#include "Search.hh"
+#include "TranspositionTable.hh"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Analyses a stream of FEN lines on all cores and writes one JSON object per line
+     *
+     * The reading thread hands positions to a bounded queue. Every worker owns a search
+     * and a hash table (cleared per position so results do not depend on scheduling).
+     * Finished results wait in a reorder buffer until every earlier line has been written,
+     * so the output is in input order.
+     */
+    class Analyzer{
+        public:
+            struct Options {
+                unsigned threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+                SearchLimits limits;        // per position budget
+                size_t hashMb = 16;         // per worker
+                int multiPV = 1;            // lines per position, more than one adds a "lines" array
+            };
+
+            Analyzer(const Options& options, std::ostream& out = std::cout)
+                : m_options(options), m_out(out), m_nextToWrite(0), m_done(false) {
+                if (m_options.threads == 0) m_options.threads = 1;
+                if (!m_options.limits.depth && !m_options.limits.nodes && !m_options.limits.movetime) m_options.limits.depth = 10;
+            }
+
+            /**
+             * @brief Analyse every line of the input, returns the number of positions
+             */
+            uint64_t run(std::istream& in) {
+                std::vector<std::thread> workers;
+                for (unsigned i = 0; i < m_options.threads; ++i) workers.emplace_back([this]() { work(); });
+
+                uint64_t sequence = 0;
+                std::string line;
+                while (std::getline(in, line)) {
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    if (line.empty()) continue;
+                    std::unique_lock<std::mutex> lock(m_queueMutex);
+                    m_queueSpace.wait(lock, [this]() { return m_queue.size() < 4 * m_options.threads; });
+                    m_queue.push_back({sequence++, line});
+                    m_queueReady.notify_one();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(m_queueMutex);
+                    m_done = true;
+                }
+                m_queueReady.notify_all();
+                for (auto& w : workers) w.join();
+                return sequence;
+            }
+
+            /**
+             * @brief Quote a string for JSON
+             */
+            static std::string jsonString(const std::string& text) {
+                std::string out = "\"";
+                for (char c : text) {
+                    if (c == '"' || c == '\\') out += '\\';
+                    if (static_cast<unsigned char>(c) < 0x20) continue;
+                    out += c;
+                }
+                return out + "\"";
+            }
+
+        private:
+            struct Job {
+                uint64_t sequence;
+                std::string fen;
+            };
+
+            void work() {
+                TranspositionTable tt(m_options.hashMb);
+                Search search(tt);
+                search.setMultiPV(m_options.multiPV);
+                for (;;) {
+                    Job job;
+                    {
+                        std::unique_lock<std::mutex> lock(m_queueMutex);
+                        m_queueReady.wait(lock, [this]() { return !m_queue.empty() || m_done; });
+                        if (m_queue.empty()) return;
+                        job = std::move(m_queue.front());
+                        m_queue.pop_front();
+                    }
+                    m_queueSpace.notify_one();
+                    write(job.sequence, analyse(job.fen, search, tt));
+                }
+            }
+
+            std::string analyse(const std::string& fen, Search& search, TranspositionTable& tt) const {
+                std::ostringstream json;
+                json << "{\"fen\":" << jsonString(fen);
+                Board board;
+                if (!board.setFen(fen)) {
+                    json << ",\"error\":\"invalid fen\"}";
+                    return json.str();
+                }
+
+                tt.clear();
+                Move best = search.think(board, m_options.limits);
+                const SearchInfo& info = search.result();
+                json << ",\"bestmove\":" << (best.isNull() ? "null" : jsonString(best.toString()));
+                if (best.isNull()) json << ",\"score\":null";
+                else json << ",\"score\":" << scoreJson(info.score);
+                json << ",\"depth\":" << info.depth << ",\"pv\":[";
+                for (size_t i = 0; i < info.pv.size(); ++i) json << (i ? "," : "") << jsonString(info.pv[i].toString());
+                json << "]";
+                if (m_options.multiPV > 1) {
+                    json << ",\"lines\":[";
+                    const std::vector<SearchInfo>& lines = search.lines();
+                    for (size_t i = 0; i < lines.size(); ++i) {
+                        json << (i ? "," : "") << "{\"multipv\":" << lines[i].multipv << ",\"score\":" << scoreJson(lines[i].score) << ",\"pv\":[";
+                        for (size_t j = 0; j < lines[i].pv.size(); ++j) json << (j ? "," : "") << jsonString(lines[i].pv[j].toString());
+                        json << "]}";
+                    }
+                    json << "]";
+                }
+                json << ",\"nodes\":" << info.nodes << ",\"time_ms\":" << info.timeMs;
+                if (SearchStats::ENABLED) json << ",\"stats\":" << search.stats().toJson();
+                json << "}";
+                return json.str();
+            }
+
+            static std::string scoreJson(int score) {
+                if (Search::isMateScore(score)) return "{\"mate\":" + std::to_string(Search::mateInMoves(score)) + "}";
+                return "{\"cp\":" + std::to_string(score) + "}";
+            }
+
+            // Reorder buffer: hold results until all earlier lines are written
+            void write(uint64_t sequence, std::string&& line) {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                m_pending.emplace(sequence, std::move(line));
+                while (!m_pending.empty() && m_pending.begin()->first == m_nextToWrite) {
+                    m_out << m_pending.begin()->second << '\n';
+                    m_pending.erase(m_pending.begin());
+                    ++m_nextToWrite;
+                }
+                m_out.flush();
+            }
+
+            Options m_options; //!worker count and per position limits
+            std::ostream& m_out; //!JSON lines output
+            std::mutex m_queueMutex; //!guards m_queue and m_done
+            std::condition_variable m_queueReady; //!signals a job or the end of input
+            std::condition_variable m_queueSpace; //!signals room in the queue
+            std::deque<Job> m_queue; //!positions waiting for a worker
+            std::mutex m_writeMutex; //!guards the reorder buffer and the output
+            std::map<uint64_t, std::string> m_pending; //!finished results that are not yet in order
+            uint64_t m_nextToWrite; //!sequence number of the next line to output
+            bool m_done; //!no more input
+    };
+}
+
+#endif
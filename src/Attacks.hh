@@ -0,0 +1,124 @@
+#ifndef ATTACKS_HH__
+#define ATTACKS_HH__
+
+namespace KS{
+
+    /** typedef for a 64-bit set of squares, bit 0 is A1 and bit 63 is H8 */
+    typedef unsigned long long Bitboard;
+
+    /** @brief index of the lowest set bit, the bitboard must not be empty */
+    inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+
+    /** @brief index of the highest set bit, the bitboard must not be empty */
+    inline int msb(Bitboard b) { return 63 - __builtin_clzll(b); }
+
+    /** @brief number of set bits */
+    inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+
+    /** @brief remove and return the lowest set bit */
+    inline int popLsb(Bitboard& b) { int s = lsb(b); b &= b - 1; return s; }
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Precomputed attack sets for every piece and square
+     *
+     * Sliding pieces use ray tables: the ray in a direction is cut at the first
+     * blocker by removing the blocker's own ray in the same direction.
+     */
+    class Attacks{
+        public:
+            // ray directions, the first four go towards higher square numbers
+            enum Direction { NORTH, EAST, NORTH_EAST, NORTH_WEST, SOUTH, WEST, SOUTH_WEST, SOUTH_EAST };
+
+            static const Bitboard FILE_A = 0x0101010101010101ULL;
+            static const Bitboard FILE_H = 0x8080808080808080ULL;
+            static const Bitboard RANK_1 = 0x00000000000000FFULL;
+            static const Bitboard RANK_8 = 0xFF00000000000000ULL;
+
+            static Bitboard knight(int square) { return tables().knight[square]; }
+            static Bitboard king(int square) { return tables().king[square]; }
+
+            /** @brief squares a pawn of color index (0 white, 1 black) attacks from square */
+            static Bitboard pawn(int colorIndex, int square) { return tables().pawn[colorIndex][square]; }
+
+            /** @brief the full ray from a square in a direction on an empty board */
+            static Bitboard ray(int direction, int square) { return tables().rays[direction][square]; }
+
+            /** @brief squares strictly between two squares on a line, empty if they are not aligned */
+            static Bitboard between(int a, int b) { return tables().between[a][b]; }
+
+            static Bitboard bishop(int square, Bitboard occupied) {
+                return slide(NORTH_EAST, square, occupied) | slide(NORTH_WEST, square, occupied)
+                     | slide(SOUTH_EAST, square, occupied) | slide(SOUTH_WEST, square, occupied);
+            }
+
+            static Bitboard rook(int square, Bitboard occupied) {
+                return slide(NORTH, square, occupied) | slide(EAST, square, occupied)
+                     | slide(SOUTH, square, occupied) | slide(WEST, square, occupied);
+            }
+
+            static Bitboard queen(int square, Bitboard occupied) {
+                return bishop(square, occupied) | rook(square, occupied);
+            }
+
+        private:
+            struct Tables{
+                Bitboard knight[64];
+                Bitboard king[64];
+                Bitboard pawn[2][64];
+                Bitboard rays[8][64];
+                Bitboard between[64][64];
+
+                Tables() {
+                    static const int fileStep[8] = {0, 1, 1, -1, 0, -1, -1, 1};
+                    static const int rankStep[8] = {1, 0, 1, 1, -1, 0, -1, -1};
+                    static const int knightJumps[8][2] = {{1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2}};
+
+                    for (int sq = 0; sq < 64; ++sq) {
+                        int file = sq & 7, rank = sq >> 3;
+                        knight[sq] = king[sq] = pawn[0][sq] = pawn[1][sq] = 0;
+                        for (auto& j : knightJumps) knight[sq] |= bit(file + j[0], rank + j[1]);
+                        for (int d = 0; d < 8; ++d) {
+                            king[sq] |= bit(file + fileStep[d], rank + rankStep[d]);
+                            rays[d][sq] = 0;
+                            for (int f = file + fileStep[d], r = rank + rankStep[d]; onBoard(f, r); f += fileStep[d], r += rankStep[d])
+                                rays[d][sq] |= 1ULL << (f + 8 * r);
+                        }
+                        pawn[0][sq] = bit(file - 1, rank + 1) | bit(file + 1, rank + 1);
+                        pawn[1][sq] = bit(file - 1, rank - 1) | bit(file + 1, rank - 1);
+                    }
+
+                    for (int a = 0; a < 64; ++a) {
+                        for (int b = 0; b < 64; ++b) {
+                            between[a][b] = 0;
+                            for (int d = 0; d < 8; ++d) {
+                                if (rays[d][a] & (1ULL << b)) {
+                                    between[a][b] = rays[d][a] & ~rays[d][b] & ~(1ULL << b);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                static bool onBoard(int file, int rank) { return file >= 0 && file < 8 && rank >= 0 && rank < 8; }
+                static Bitboard bit(int file, int rank) { return onBoard(file, rank) ? 1ULL << (file + 8 * rank) : 0; }
+            };
+
+            static const Tables& tables() {
+                static const Tables t;
+                return t;
+            }
+
+            static Bitboard slide(int direction, int square, Bitboard occupied) {
+                Bitboard attacks = tables().rays[direction][square];
+                Bitboard blockers = attacks & occupied;
+                if (blockers) {
+                    int first = direction < SOUTH ? lsb(blockers) : msb(blockers);
+                    attacks ^= tables().rays[direction][first];
+                }
+                return attacks;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef BENCH_HH__
+#define BENCH_HH__
+
+#include "Board.hh"
+#include "Search.hh"
+#include "TranspositionTable.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Fixed single threaded search of a fixed set of positions
+     *
+     * The total node count is a signature of the search: any change to move
+     * generation, ordering, pruning or evaluation changes it, while builds and
+     * machines do not. The speed (nps) is the number to compare between builds.
+     * This is also the training run of the profile guided build.
+     */
+    class Bench{
+        public:
+            static const int DEFAULT_DEPTH = 10;
+
+            struct Result {
+                uint64_t nodes = 0;
+                int64_t timeMs = 0;
+                uint64_t nps() const { return nodes * 1000 / (timeMs > 0 ? timeMs : 1); }
+            };
+
+            /**
+             * @brief Search every position to the depth with a fresh hash table, printing one line each;
+             *        the depth is clamped to 1 .. Search::MAX_PLY - 1, as 0 would search without end
+             */
+            static Result run(int depth = DEFAULT_DEPTH, std::ostream& out = std::cout) {
+                depth = std::max(1, std::min(depth, Search::MAX_PLY - 1));
+                static const char* const positions[] = {
+                    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+                    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+                    "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+                    "2r3k1/pp3ppp/2n1b3/3p4/3P4/2P1BN2/P4PPP/2R3K1 w - - 0 22",
+                    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+                    "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+                    "r2q1rk1/pb2bppp/1pn1pn2/2pp4/3P4/1PNBPN2/PB3PPP/R2Q1RK1 w - - 0 10",
+                    "8/5pk1/6p1/8/3Q4/6P1/5PK1/3q4 b - - 0 40",
+                };
+
+                Result total;
+                for (const char* fen : positions) {
+                    TranspositionTable tt(16);
+                    Search search(tt);
+                    SearchLimits limits;
+                    limits.depth = depth;
+                    Board board(fen);
+                    int64_t start = nowMs();
+                    Move best = search.think(board, limits);
+                    int64_t ms = nowMs() - start;
+                    total.nodes += search.nodes();
+                    total.timeMs += ms;
+                    out << fen << "  " << best.toString() << "  " << search.nodes() << " nodes" << std::endl;
+                }
+                out << "===========================\n"
+                    << "Total time (ms) : " << total.timeMs << "\n"
+                    << "Nodes searched  : " << total.nodes << "\n"
+                    << "Nodes/second    : " << total.nps() << std::endl;
+                return total;
+            }
+
+        private:
+            static int64_t nowMs() {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+    };
+}
+
+#endif
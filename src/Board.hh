@@ -2,34 +2,166 @@
 #define BOARD_HH__
 
 #include "Piece.hh"
+#include "Move.hh"
+#include "Attacks.hh"
+#include "Zobrist.hh"
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace KS{
 
 class Board {
+public:
+    static const int WHITE_KINGSIDE = 1;
+    static const int WHITE_QUEENSIDE = 2;
+    static const int BLACK_KINGSIDE = 4;
+    static const int BLACK_QUEENSIDE = 8;
+
+    // Keys kept for repetition detection; a position can only repeat within the halfmove clock, which never passes 100 unnoticed
+    static const int HISTORY = 128;
+
+    enum GameState { ONGOING, CHECKMATE, STALEMATE, REPETITION, FIFTY_MOVES, INSUFFICIENT_MATERIAL };
+
+    static constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // Everything makeMove() overwrites that cannot be recomputed from the move itself
+    struct Undo {
+        int captured;
+        int castlingRights;
+        int epSquare;
+        int halfmoves;
+        uint64_t hash;
+    };
+
+    // Fixed layout copy of a position with its repetition history, for save files (see pack() and unpack())
+    struct Packed {
+        uint8_t squares[64];  // piece codes, Piece::NONE for empty squares
+        uint8_t side;
+        uint8_t castlingRights;
+        int8_t epSquare;
+        uint8_t reserved;
+        uint16_t halfmoves;
+        uint16_t fullmoves;
+        uint32_t ply;
+        uint32_t padding;
+        uint64_t keyHistory[HISTORY];
+    };
+
 private:
     int board[64];  // An array representing the 64 squares of the chessboard
+    Bitboard pieceBB[2][8];  // Squares of each piece type, indexed by color index and Piece type
+    Bitboard colorBB[2];  // Squares of all pieces of a color
+    int side;  // Piece::WHITE or Piece::BLACK
+    int castlingRights;  // WHITE_KINGSIDE | WHITE_QUEENSIDE | BLACK_KINGSIDE | BLACK_QUEENSIDE
+    int epSquare;  // Square a pawn can capture en passant onto, -1 if none
+    int halfmoves;  // Halfmoves since the last capture or pawn move
+    int fullmoves;  // Starts at 1 and is incremented after black moves
+    uint64_t hash;  // Zobrist key of the position
+    uint64_t material;  // Count of every piece type of each color, 4 bits each (see materialUnit)
+    uint64_t keyHistory[HISTORY];  // Ring of the keys of earlier positions, indexed by ply & (HISTORY - 1)
+    int ply;  // Plies played since the position was set up
+
+    static uint64_t materialUnit(int piece) {
+        return 1ULL << (4 * (Piece::ColorIndex(Piece::Color(piece)) * 8 + Piece::PieceType(piece)));
+    }
 
     // Initialize the board to the starting setup
     void initBoard() {
-        // White pieces
-        board[0] = Piece::ROOK | Piece::WHITE;      // A1
-        board[1] = Piece::KNIGHT | Piece::WHITE;    // B1
-        board[2] = Piece::BISHOP | Piece::WHITE;    // C1
-        board[3] = Piece::QUEEN | Piece::WHITE;     // D1
-        board[4] = Piece::KING | Piece::WHITE;      // E1
-        board[5] = Piece::BISHOP | Piece::WHITE;    // F1
-        board[6] = Piece::KNIGHT | Piece::WHITE;    // G1
-        board[7] = Piece::ROOK | Piece::WHITE;      // H1
-        for (int i = 8; i < 16; ++i) board[i] = Piece::PAWN | Piece::WHITE;  // White pawns
-
-        // Black pieces
-        board[56] = Piece::ROOK | Piece::BLACK;     // A8
-        board[57] = Piece::KNIGHT | Piece::BLACK;   // B8
-        board[58] = Piece::BISHOP | Piece::BLACK;   // C8
-        board[59] = Piece::QUEEN | Piece::BLACK;    // D8
-        board[60] = Piece::KING | Piece::BLACK;     // E8
-        board[61] = Piece::BISHOP | Piece::BLACK;   // F8
-        board[62] = Piece::KNIGHT | Piece::BLACK;   // G8
-        board[63] = Piece::ROOK | Piece::BLACK;     // H8
-        for (int i = 48; i < 56; ++i) board[i] = Piece::PAWN | Piece::BLACK;  // Black pawns
+        setFen(START_FEN);
+    }
+
+    void clear() {
+        for (int i = 0; i < 64; ++i) board[i] = Piece::NONE;
+        for (auto& c : pieceBB)
+            for (auto& b : c) b = 0;
+        colorBB[0] = colorBB[1] = 0;
+        side = Piece::WHITE;
+        castlingRights = 0;
+        epSquare = -1;
+        halfmoves = 0;
+        fullmoves = 1;
+        hash = 0;
+        material = 0;
+        ply = 0;
+    }
+
+    void addPiece(int square, int piece) {
+        int c = Piece::ColorIndex(Piece::Color(piece));
+        board[square] = piece;
+        pieceBB[c][Piece::PieceType(piece)] |= 1ULL << square;
+        colorBB[c] |= 1ULL << square;
+        hash ^= Zobrist::piece(piece, square);
+        material += materialUnit(piece);
+    }
+
+    void removePiece(int square) {
+        int piece = board[square];
+        int c = Piece::ColorIndex(Piece::Color(piece));
+        board[square] = Piece::NONE;
+        pieceBB[c][Piece::PieceType(piece)] &= ~(1ULL << square);
+        colorBB[c] &= ~(1ULL << square);
+        hash ^= Zobrist::piece(piece, square);
+        material -= materialUnit(piece);
+    }
+
+    void movePiece(int from, int to) {
+        int piece = board[from];
+        removePiece(from);
+        addPiece(to, piece);
+    }
+
+    // Castling rights that survive a move touching a square
+    static int castlingMask(int square) {
+        switch (square) {
+            case 0: return ~WHITE_QUEENSIDE;
+            case 4: return ~(WHITE_KINGSIDE | WHITE_QUEENSIDE);
+            case 7: return ~WHITE_KINGSIDE;
+            case 56: return ~BLACK_QUEENSIDE;
+            case 60: return ~(BLACK_KINGSIDE | BLACK_QUEENSIDE);
+            case 63: return ~BLACK_KINGSIDE;
+            default: return ~0;
+        }
+    }
+
+    // A position the move generator can handle: one king of each color, no pawn on the first or last
+    // rank, and castling rights only while the king and that rook stand on their home squares
+    bool validSetup() const {
+        if (popCount(pieceBB[0][Piece::KING]) != 1 || popCount(pieceBB[1][Piece::KING]) != 1) return false;
+        if ((pieceBB[0][Piece::PAWN] | pieceBB[1][Piece::PAWN]) & (Attacks::RANK_1 | Attacks::RANK_8)) return false;
+        static const int rookHome[4] = {7, 0, 63, 56};  // h1, a1, h8, a8 for the rights 1, 2, 4, 8
+        for (int right = 0; right < 4; ++right) {
+            if (!(castlingRights & (1 << right))) continue;
+            int color = right < 2 ? Piece::WHITE : Piece::BLACK;
+            if (board[right < 2 ? 4 : 60] != (Piece::KING | color) || board[rookHome[right]] != (Piece::ROOK | color)) return false;
+        }
+        return true;
+    }
+
+    // Only remember an en passant square an enemy pawn can actually capture on, so equal positions hash equally
+    void setEnPassant(int square, int capturingColor) {
+        int c = Piece::ColorIndex(capturingColor);
+        if (Attacks::pawn(c ^ 1, square) & pieceBB[c][Piece::PAWN]) {
+            epSquare = square;
+            hash ^= Zobrist::enPassant(square & 7);
+        }
+    }
+
+    void addPawnMoves(int from, int to, int flags, MoveList& list) const {
+        if (to >= 56 || to < 8) {
+            int promo = (flags & Move::CAPTURE) ? Move::PROMOTION_CAPTURE : Move::PROMOTION;
+            for (int p = 0; p < 4; ++p) list.add(Move(from, to, promo | p));
+        } else {
+            list.add(Move(from, to, flags));
+        }
+    }
+
+    void addTargets(int from, Bitboard targets, MoveList& list) const {
+        while (targets) {
+            int to = popLsb(targets);
+            list.add(Move(from, to, board[to] != Piece::NONE ? Move::CAPTURE : Move::QUIET));
+        }
     }
 
 public:
@@ -37,68 +169,425 @@ public:
         initBoard();  // Initialize the board with the starting setup
     }
 
+    explicit Board(const std::string& fen) {
+        if (!setFen(fen)) initBoard();
+    }
+
     // Function that checks if a square is occupied by a piece
-    bool isOccupied(int square) {
+    bool isOccupied(int square) const {
         return board[square] != Piece::NONE;
     }
 
-    // Function that returns a 64-bit array representing available moves for a piece
-    unsigned long long getAvailableMoves(int square) {
-        int piece = board[square];
-        unsigned long long availableMoves = 0;
+    int pieceAt(int square) const { return board[square]; }
+    int sideToMove() const { return side; }
+    int castling() const { return castlingRights; }
+    int enPassantSquare() const { return epSquare; }
+    int halfmoveClock() const { return halfmoves; }
+    int fullmoveNumber() const { return fullmoves; }
+    uint64_t zobrist() const { return hash; }
+
+    Bitboard pieces(int color, int type) const { return pieceBB[Piece::ColorIndex(color)][type]; }
+    Bitboard pieces(int color) const { return colorBB[Piece::ColorIndex(color)]; }
+    Bitboard occupied() const { return colorBB[0] | colorBB[1]; }
+    int kingSquare(int color) const { return lsb(pieces(color, Piece::KING)); }
+
+    // Function that returns every piece of either color attacking a square given the occupancy
+    Bitboard attackersTo(int square, Bitboard occ) const {
+        Bitboard rooks = pieceBB[0][Piece::ROOK] | pieceBB[1][Piece::ROOK] | pieceBB[0][Piece::QUEEN] | pieceBB[1][Piece::QUEEN];
+        Bitboard bishops = pieceBB[0][Piece::BISHOP] | pieceBB[1][Piece::BISHOP] | pieceBB[0][Piece::QUEEN] | pieceBB[1][Piece::QUEEN];
+        return (Attacks::pawn(1, square) & pieceBB[0][Piece::PAWN])
+             | (Attacks::pawn(0, square) & pieceBB[1][Piece::PAWN])
+             | (Attacks::knight(square) & (pieceBB[0][Piece::KNIGHT] | pieceBB[1][Piece::KNIGHT]))
+             | (Attacks::king(square) & (pieceBB[0][Piece::KING] | pieceBB[1][Piece::KING]))
+             | (Attacks::rook(square, occ) & rooks)
+             | (Attacks::bishop(square, occ) & bishops);
+    }
+
+    // Function that checks if any piece of the given color attacks a square
+    bool isSquareAttacked(int square, int byColor) const {
+        int c = Piece::ColorIndex(byColor);
+        Bitboard occ = occupied();
+        return (Attacks::pawn(c ^ 1, square) & pieceBB[c][Piece::PAWN])
+            || (Attacks::knight(square) & pieceBB[c][Piece::KNIGHT])
+            || (Attacks::king(square) & pieceBB[c][Piece::KING])
+            || (Attacks::rook(square, occ) & (pieceBB[c][Piece::ROOK] | pieceBB[c][Piece::QUEEN]))
+            || (Attacks::bishop(square, occ) & (pieceBB[c][Piece::BISHOP] | pieceBB[c][Piece::QUEEN]));
+    }
+
+    // Function that checks if the side to move is in check
+    bool inCheck() const {
+        return isSquareAttacked(kingSquare(side), Piece::Opposite(side));
+    }
+
+    // Function that checks if the side that just moved left its own king attacked
+    bool leftInCheck() const {
+        return isSquareAttacked(kingSquare(Piece::Opposite(side)), side);
+    }
+
+    // Function that generates all pseudo-legal moves (the king may be left in check)
+    // in a fixed order: by from square ascending, then by to square ascending
+    void generatePseudoMoves(MoveList& list, bool capturesOnly = false) const {
+        for (Bitboard mine = colorBB[Piece::ColorIndex(side)]; mine; ) addPieceMoves(popLsb(mine), capturesOnly, list);
+    }
 
-        if (piece == Piece::NONE) return availableMoves;
-
-        // Check for movement possibilities for the piece at the square
-        // Here you can define the logic for each piece type (pawn, knight, etc.)
-        switch (Piece::PieceType(piece)) {
-            case Piece::PAWN:
-                // Example: Pawns move forward (for simplicity, just checking 1 square ahead)
-                if (Piece::isColor(piece, Piece::WHITE)) {
-                    if (square - 8 >= 0 && !isOccupied(square - 8)) {
-                        availableMoves |= (1ULL << (square - 8)); // Move forward one square
-                    }
-                } else {
-                    if (square + 8 < 64 && !isOccupied(square + 8)) {
-                        availableMoves |= (1ULL << (square + 8)); // Move forward one square
-                    }
+    // Function that adds the pseudo-legal moves of the side to move's piece on from, by to square ascending
+    void addPieceMoves(int from, bool capturesOnly, MoveList& list) const {
+        int us = Piece::ColorIndex(side);
+        Bitboard own = colorBB[us];
+        Bitboard enemy = colorBB[us ^ 1];
+        Bitboard occ = own | enemy;
+        Bitboard targetMask = capturesOnly ? enemy : ~own;
+        int forward = side == Piece::WHITE ? 8 : -8;
+        switch (Piece::PieceType(board[from])) {
+            case Piece::PAWN: {
+                int one = from + forward;
+                int rank = from >> 3;
+                bool promoting = (one >= 56 || one < 8);
+                Bitboard captures = Attacks::pawn(us, from);
+                // keep pushes and captures in to-square order
+                Bitboard targets = (captures & enemy);
+                if (!isOccupied(one) && (!capturesOnly || promoting)) {
+                    targets |= 1ULL << one;
+                    int startRank = side == Piece::WHITE ? 1 : 6;
+                    if (rank == startRank && !capturesOnly && !isOccupied(one + forward)) targets |= 1ULL << (one + forward);
+                }
+                if (epSquare >= 0 && (captures & (1ULL << epSquare))) targets |= 1ULL << epSquare;
+                while (targets) {
+                    int to = popLsb(targets);
+                    if (to == epSquare && (captures & (1ULL << to)) && !isOccupied(to)) list.add(Move(from, to, Move::EN_PASSANT));
+                    else if (isOccupied(to)) addPawnMoves(from, to, Move::CAPTURE, list);
+                    else if (to == one + forward) list.add(Move(from, to, Move::DOUBLE_PUSH));
+                    else addPawnMoves(from, to, Move::QUIET, list);
                 }
                 break;
-
+            }
             case Piece::KNIGHT:
-                // Knights have an "L" shape move (8 possible squares)
-                // Add logic for the knight's movement here
+                addTargets(from, Attacks::knight(from) & targetMask, list);
                 break;
-
             case Piece::BISHOP:
-                // Bishops move diagonally
-                // Add logic for the bishop's movement here
+                addTargets(from, Attacks::bishop(from, occ) & targetMask, list);
                 break;
-
             case Piece::ROOK:
-                // Rooks move horizontally or vertically
-                // Add logic for the rook's movement here
+                addTargets(from, Attacks::rook(from, occ) & targetMask, list);
                 break;
-
             case Piece::QUEEN:
-                // Queens move both like rooks and bishops
-                // Add logic for the queen's movement here
+                addTargets(from, Attacks::queen(from, occ) & targetMask, list);
                 break;
-
-            case Piece::KING:
-                // Kings move one square in any direction
-                // Add logic for the king's movement here
+            case Piece::KING: {
+                Bitboard targets = Attacks::king(from) & targetMask;
+                int them = Piece::Opposite(side);
+                int kingside = side == Piece::WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+                int queenside = side == Piece::WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+                bool canCastle = !capturesOnly && (castlingRights & (kingside | queenside)) && !isSquareAttacked(from, them);
+                if (canCastle && (castlingRights & queenside) && !(occ & Attacks::between(from, from - 4)) && !isSquareAttacked(from - 1, them))
+                    list.add(Move(from, from - 2, Move::QUEEN_CASTLE));
+                while (targets) {
+                    int to = popLsb(targets);
+                    list.add(Move(from, to, isOccupied(to) ? Move::CAPTURE : Move::QUIET));
+                }
+                if (canCastle && (castlingRights & kingside) && !(occ & Attacks::between(from, from + 3)) && !isSquareAttacked(from + 1, them))
+                    list.add(Move(from, from + 2, Move::KING_CASTLE));
                 break;
-
+            }
             default:
                 break;
         }
+    }
 
+    // Function that generates all legal moves in the same fixed order as generatePseudoMoves()
+    void generateLegalMoves(MoveList& list) {
+        MoveList pseudo;
+        generatePseudoMoves(pseudo);
+        list.count = 0;
+        for (const Move& m : pseudo) {
+            Undo u;
+            makeMove(m, u);
+            if (!leftInCheck()) list.add(m);
+            unmakeMove(m, u);
+        }
+    }
+
+    // Function that checks if a move from the pseudo-legal generator is legal
+    bool isLegal(const Move& m) {
+        Undo u;
+        makeMove(m, u);
+        bool legal = !leftInCheck();
+        unmakeMove(m, u);
+        return legal;
+    }
+
+    // Function that returns a 64-bit array representing available moves for a piece
+    // Only pieces of the side to move have available moves; only that piece's moves are generated
+    unsigned long long getAvailableMoves(int square) {
+        unsigned long long availableMoves = 0;
+        if (!Piece::isColor(board[square], side)) return availableMoves;
+
+        MoveList moves;
+        addPieceMoves(square, false, moves);
+        for (const Move& m : moves) {
+            if (isLegal(m)) availableMoves |= (1ULL << m.to());
+        }
         return availableMoves;
     }
 
+    // Function that finds the legal move matching long algebraic text such as "e2e4" or "e7e8q", null if none
+    Move parseMove(const std::string& text) {
+        MoveList moves;
+        generateLegalMoves(moves);
+        for (const Move& m : moves) {
+            if (m.toString() == text) return m;
+        }
+        return Move();
+    }
+
+    // Function that plays a move (assumed pseudo-legal) and remembers how to take it back
+    void makeMove(const Move& m, Undo& u) {
+        int from = m.from(), to = m.to(), flags = m.flags();
+        int piece = board[from];
+        u = {board[to], castlingRights, epSquare, halfmoves, hash};
+
+        hash ^= Zobrist::castling(castlingRights);
+        if (epSquare >= 0) hash ^= Zobrist::enPassant(epSquare & 7);
+        epSquare = -1;
+        ++halfmoves;
+
+        if (flags == Move::EN_PASSANT) {
+            int capturedSquare = to + (side == Piece::WHITE ? -8 : 8);
+            u.captured = board[capturedSquare];
+            removePiece(capturedSquare);
+        } else if (m.isCapture()) {
+            removePiece(to);
+        }
+        if (m.isCapture() || Piece::PieceType(piece) == Piece::PAWN) halfmoves = 0;
+
+        movePiece(from, to);
+        if (m.isPromotion()) {
+            removePiece(to);
+            addPiece(to, m.promotionType() | side);
+        } else if (flags == Move::DOUBLE_PUSH) {
+            setEnPassant((from + to) / 2, Piece::Opposite(side));
+        } else if (flags == Move::KING_CASTLE) {
+            movePiece(to + 1, to - 1);
+        } else if (flags == Move::QUEEN_CASTLE) {
+            movePiece(to - 2, to + 1);
+        }
+
+        castlingRights &= castlingMask(from) & castlingMask(to);
+        hash ^= Zobrist::castling(castlingRights);
+
+        if (side == Piece::BLACK) ++fullmoves;
+        side = Piece::Opposite(side);
+        hash ^= Zobrist::side();
+        keyHistory[++ply & (HISTORY - 1)] = hash;
+    }
+
+    // Function that takes back the move last played with makeMove()
+    void unmakeMove(const Move& m, const Undo& u) {
+        int from = m.from(), to = m.to(), flags = m.flags();
+        side = Piece::Opposite(side);
+        if (side == Piece::BLACK) --fullmoves;
+
+        if (m.isPromotion()) {
+            removePiece(to);
+            addPiece(to, Piece::PAWN | side);
+        } else if (flags == Move::KING_CASTLE) {
+            movePiece(to - 1, to + 1);
+        } else if (flags == Move::QUEEN_CASTLE) {
+            movePiece(to + 1, to - 2);
+        }
+        movePiece(to, from);
+
+        if (flags == Move::EN_PASSANT) addPiece(to + (side == Piece::WHITE ? -8 : 8), u.captured);
+        else if (m.isCapture()) addPiece(to, u.captured);
+
+        castlingRights = u.castlingRights;
+        epSquare = u.epSquare;
+        halfmoves = u.halfmoves;
+        hash = u.hash;
+        --ply;
+    }
+
+    // Function that passes the turn without moving (used by the search)
+    void makeNullMove(Undo& u) {
+        u = {Piece::NONE, castlingRights, epSquare, halfmoves, hash};
+        if (epSquare >= 0) hash ^= Zobrist::enPassant(epSquare & 7);
+        epSquare = -1;
+        halfmoves = 0;  // positions before a null move cannot count as repetitions
+        side = Piece::Opposite(side);
+        hash ^= Zobrist::side();
+        keyHistory[++ply & (HISTORY - 1)] = hash;
+    }
+
+    void unmakeNullMove(const Undo& u) {
+        side = Piece::Opposite(side);
+        epSquare = u.epSquare;
+        halfmoves = u.halfmoves;
+        hash = u.hash;
+        --ply;
+    }
+
+    // Function that sets up a position from Forsyth-Edwards Notation, returns false (and the start position)
+    // if the text is malformed or the position fails validSetup()
+    bool setFen(const std::string& fen) {
+        std::istringstream in(fen);
+        std::string placement, color, castle = "-", ep = "-";
+        int half = 0, full = 1;
+        if (!(in >> placement >> color)) return false;
+        in >> castle >> ep >> half >> full;
+
+        clear();
+        int rank = 7, file = 0;
+        for (char c : placement) {
+            if (c == '/') {
+                --rank;
+                file = 0;
+            } else if (c >= '1' && c <= '8') {
+                file += c - '0';
+            } else {
+                int piece = Piece::FromChar(c);
+                if (piece == Piece::NONE || file > 7 || rank < 0) { initBoard(); return false; }
+                addPiece(rank * 8 + file, piece);
+                ++file;
+            }
+        }
+        side = color == "b" ? Piece::BLACK : Piece::WHITE;
+        if (side == Piece::BLACK) hash ^= Zobrist::side();
+        for (char c : castle) {
+            if (c == 'K') castlingRights |= WHITE_KINGSIDE;
+            else if (c == 'Q') castlingRights |= WHITE_QUEENSIDE;
+            else if (c == 'k') castlingRights |= BLACK_KINGSIDE;
+            else if (c == 'q') castlingRights |= BLACK_QUEENSIDE;
+        }
+        hash ^= Zobrist::castling(castlingRights);
+        if (!validSetup()) { initBoard(); return false; }
+        int epSq = Move::parseSquare(ep);
+        if (epSq >= 0) setEnPassant(epSq, side);
+        halfmoves = half;
+        fullmoves = full;
+        keyHistory[0] = hash;
+        return true;
+    }
+
+    // Piece counts packed 4 bits per color and Piece type, equal for positions with the same material
+    uint64_t materialKey() const {
+        return material;
+    }
+
+    // Function that checks if the position occurred before since the last capture, pawn move or null move.
+    // A repetition of a position reached inside the search (less than searchPly plies ago) already counts as
+    // a draw; older ones only when the position occurred twice before, as the threefold rule requires.
+    bool isRepetition(int searchPly = 0) const {
+        int window = halfmoves < ply ? halfmoves : ply;
+        if (window > HISTORY - 1) window = HISTORY - 1;
+        int earlier = 0;
+        for (int back = 4; back <= window; back += 2) {  // the same side is to move only every other ply
+            if (keyHistory[(ply - back) & (HISTORY - 1)] != hash) continue;
+            if (back < searchPly || ++earlier == 2) return true;
+        }
+        return false;
+    }
+
+    // Function that checks the threefold repetition rule
+    bool isThreefoldRepetition() const {
+        return isRepetition(0);
+    }
+
+    // Function that checks the fifty-move rule (a checkmate on the hundredth halfmove still wins)
+    bool isFiftyMoveDraw() const {
+        return halfmoves >= 100;
+    }
+
+    // Function that checks that neither side can possibly mate: king against king and at most one minor piece,
+    // or only bishops left that all stand on squares of one color
+    bool isInsufficientMaterial() const {
+        static const uint64_t kings = materialUnit(Piece::KING | Piece::WHITE) | materialUnit(Piece::KING | Piece::BLACK);
+        static const uint64_t bishopCounts = 0xFULL * (materialUnit(Piece::BISHOP | Piece::WHITE) | materialUnit(Piece::BISHOP | Piece::BLACK));
+        uint64_t rest = material - kings;
+        if (rest == 0 || rest == materialUnit(Piece::KNIGHT | Piece::WHITE) || rest == materialUnit(Piece::KNIGHT | Piece::BLACK)) return true;
+        if (rest & ~bishopCounts) return false;
+        const Bitboard darkSquares = 0xAA55AA55AA55AA55ULL;
+        Bitboard bishops = pieceBB[0][Piece::BISHOP] | pieceBB[1][Piece::BISHOP];
+        return !(bishops & darkSquares) || !(bishops & ~darkSquares);
+    }
+
+    // Function that decides whether the game is over, and how
+    GameState gameState() {
+        MoveList moves;
+        generateLegalMoves(moves);
+        if (moves.size() == 0) return inCheck() ? CHECKMATE : STALEMATE;
+        if (isFiftyMoveDraw()) return FIFTY_MOVES;
+        if (isThreefoldRepetition()) return REPETITION;
+        if (isInsufficientMaterial()) return INSUFFICIENT_MATERIAL;
+        return ONGOING;
+    }
+
+    // Function that writes the position in Forsyth-Edwards Notation
+    std::string fen() const {
+        std::string out;
+        for (int rank = 7; rank >= 0; --rank) {
+            int empty = 0;
+            for (int file = 0; file < 8; ++file) {
+                int piece = board[rank * 8 + file];
+                if (piece == Piece::NONE) { ++empty; continue; }
+                if (empty) { out += static_cast<char>('0' + empty); empty = 0; }
+                out += Piece::ToChar(piece);
+            }
+            if (empty) out += static_cast<char>('0' + empty);
+            if (rank) out += '/';
+        }
+        out += side == Piece::WHITE ? " w " : " b ";
+        if (!castlingRights) out += '-';
+        if (castlingRights & WHITE_KINGSIDE) out += 'K';
+        if (castlingRights & WHITE_QUEENSIDE) out += 'Q';
+        if (castlingRights & BLACK_KINGSIDE) out += 'k';
+        if (castlingRights & BLACK_QUEENSIDE) out += 'q';
+        out += ' ' + (epSquare >= 0 ? Move::squareName(epSquare) : std::string("-"));
+        out += ' ' + std::to_string(halfmoves) + ' ' + std::to_string(fullmoves);
+        return out;
+    }
+
+    // Function that copies the position into the fixed layout of a save file
+    Packed pack() const {
+        Packed p = {};
+        for (int i = 0; i < 64; ++i) p.squares[i] = static_cast<uint8_t>(board[i]);
+        p.side = static_cast<uint8_t>(side);
+        p.castlingRights = static_cast<uint8_t>(castlingRights);
+        p.epSquare = static_cast<int8_t>(epSquare);
+        p.halfmoves = static_cast<uint16_t>(halfmoves);
+        p.fullmoves = static_cast<uint16_t>(fullmoves);
+        p.ply = static_cast<uint32_t>(ply);
+        for (int i = 0; i < HISTORY; ++i) p.keyHistory[i] = keyHistory[i];
+        return p;
+    }
+
+    // Function that restores a packed position; false (and the start position) if it is not consistent,
+    // e.g. written with other Zobrist keys
+    bool unpack(const Packed& p) {
+        clear();
+        for (int i = 0; i < 64; ++i) {
+            if (p.squares[i] == Piece::NONE) continue;
+            if (Piece::FromChar(Piece::ToChar(p.squares[i])) != p.squares[i]) { initBoard(); return false; }
+            addPiece(i, p.squares[i]);
+        }
+        side = p.side == Piece::BLACK ? Piece::BLACK : Piece::WHITE;
+        if (side == Piece::BLACK) hash ^= Zobrist::side();
+        castlingRights = p.castlingRights & 15;
+        hash ^= Zobrist::castling(castlingRights);
+        epSquare = p.epSquare >= 0 && p.epSquare < 64 ? p.epSquare : -1;
+        if (epSquare >= 0) hash ^= Zobrist::enPassant(epSquare & 7);
+        halfmoves = p.halfmoves;
+        fullmoves = p.fullmoves;
+        ply = static_cast<int>(p.ply);
+        for (int i = 0; i < HISTORY; ++i) keyHistory[i] = p.keyHistory[i];
+        if (!validSetup() || keyHistory[ply & (HISTORY - 1)] != hash) {
+            initBoard();
+            return false;
+        }
+        return true;
+    }
+
     // Function to print the board (for debugging)
-    void printBoard() {
+    void printBoard() const {
         for (int i = 0; i < 64; ++i) {
             std::cout << board[i] << " ";
             if ((i + 1) % 8 == 0) std::cout << std::endl;
@@ -106,4 +595,6 @@ public:
     }
 };
 
+}
+
 #endif
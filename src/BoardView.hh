@@ -0,0 +1,429 @@
+#ifndef BOARDVIEW_HH__
+#define BOARDVIEW_HH__
+
+#include "Board.hh"
+#include "Move.hh"
+#include "Piece.hh"
+#include "SpriteCache.hh"
+#include "Widget.hh"
+#include "Window.hh"
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+#include <FL/fl_draw.H>
+#include <chrono>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief The whole chess board as one widget: squares, highlights and pieces in one draw()
+     *
+     * Every change marks only the squares it affects as dirty and damages the widget
+     * with FL_DAMAGE_USER1; the next draw repaints just those squares. Any other damage
+     * (expose, resize, a redraw of the window) repaints all 64. A move therefore costs
+     * 2 to 4 square repaints (from, to, the previous move's squares, rook or captured pawn).
+     * Pieces are drawn from a SpriteCache when one is set.
+     *
+     * Moves can be animated: the piece slides to its square and a capture flashes.
+     * All animations share one Fl::add_timeout tick per frame and live in a fixed
+     * array of slots. A frame damages only the rectangles the sliding piece left and
+     * entered, so FLTK clips the repaint to those few pixels.
+     */
+    class BoardView : public AUGL::Widget{
+        public:
+            static constexpr double FRAME_SECONDS = 1.0 / 60;
+            static constexpr double SLIDE_SECONDS = 0.15;
+            static constexpr double FLASH_SECONDS = 0.3;
+            static const int MAX_ANIMATIONS = 8;
+
+            BoardView(const AUGL::Point& p, int squareSize)
+                : AUGL::Widget(p, squareSize * 8, squareSize * 8, {""}, nullptr), m_size(squareSize), m_sprites(nullptr), m_selected(-1),
+                  m_targets(0), m_check(-1), m_flipped(false), m_dirtySquares(0), m_hidden(0), m_frameTime(0),
+                  m_dragSquare(-1), m_dragX(0), m_dragY(0) {
+                for (int& piece : m_pieces) piece = Piece::NONE;
+            }
+
+            ~BoardView() {
+                Fl::remove_timeout(tick, this);
+            }
+
+            void attach(AUGL::Window* window) override {
+                m_owner = window;
+                m_widget = new Canvas(*this);
+            }
+
+            void draw() override { m_widget->draw(); }
+
+            /**
+             * @brief Draw the pieces from these images, the cache must outlive the view
+             */
+            void setSprites(SpriteCache* sprites) {
+                m_sprites = sprites;
+                if (m_widget) m_widget->redraw();
+            }
+
+            /**
+             * @brief Change the size of the squares, the upper left corner stays
+             */
+            void setSquareSize(int squareSize) {
+                if (squareSize == m_size) return;
+                finishAnimations();
+                redraw();
+                m_size = squareSize;
+                m_width = m_height = squareSize * 8;
+                if (m_widget) m_widget->size(m_width, m_height);
+                redraw();
+            }
+
+            /**
+             * @brief Show a position, only squares whose piece changed are repainted
+             */
+            void setPosition(const Board& board) {
+                Bitboard changed = 0;
+                for (int sq = 0; sq < 64; ++sq) {
+                    if (m_pieces[sq] != board.pieceAt(sq)) {
+                        m_pieces[sq] = board.pieceAt(sq);
+                        changed |= 1ULL << sq;
+                    }
+                }
+                int check = board.inCheck() ? board.kingSquare(board.sideToMove()) : -1;
+                if (check != m_check) {
+                    changed |= squareBit(m_check) | squareBit(check);
+                    m_check = check;
+                }
+                invalidate(changed);
+            }
+
+            /**
+             * @brief Highlight the from and to squares of the last move, a null move clears it
+             */
+            void setLastMove(const Move& move) {
+                if (move == m_lastMove) return;
+                invalidate(moveBits(m_lastMove) | moveBits(move));
+                m_lastMove = move;
+            }
+
+            /**
+             * @brief Highlight a selected square, -1 for none
+             */
+            void setSelected(int square) {
+                if (square == m_selected) return;
+                invalidate(squareBit(m_selected) | squareBit(square));
+                m_selected = square;
+            }
+
+            /**
+             * @brief Mark the squares a selected piece can move to
+             */
+            void setTargets(Bitboard targets) {
+                invalidate(m_targets ^ targets);
+                m_targets = targets;
+            }
+
+            /**
+             * @brief Show the board from black's side
+             */
+            void setFlipped(bool flipped) {
+                if (flipped == m_flipped) return;
+                finishAnimations();
+                m_flipped = flipped;
+                if (m_widget) m_widget->redraw();
+            }
+
+            /**
+             * @brief Slide the piece of a move (and the rook of a castle) and flash a capture.
+             *        Call it with the position before the move, then setPosition with the one after.
+             */
+            void animateMove(const Board& before, const Move& move) {
+                finishAnimations();
+                if (move.isNull()) return;
+                int captured = move.flags() == Move::EN_PASSANT ? Piece::NONE : before.pieceAt(move.to());
+                slide(before.pieceAt(move.from()), move.from(), move.to(), captured);
+                if (move.isCastle()) {
+                    int corner = move.from() - move.from() % 8;
+                    bool kingSide = move.flags() == Move::KING_CASTLE;
+                    int rookFrom = corner + (kingSide ? 7 : 0), rookTo = corner + (kingSide ? 5 : 3);
+                    slide(before.pieceAt(rookFrom), rookFrom, rookTo, Piece::NONE);
+                }
+                if (move.isCapture()) flash(move.to(), CHECK, SLIDE_SECONDS);
+            }
+
+            /**
+             * @brief Jump every animation to its end
+             */
+            void finishAnimations() {
+                for (Animation& a : m_animations) {
+                    if (a.kind == Animation::SLIDE) damageSprite(a.x, a.y);
+                    if (a.kind != Animation::NONE) invalidate(squareBit(a.to));
+                    a.kind = Animation::NONE;
+                }
+                m_hidden = 0;
+                Fl::remove_timeout(tick, this);
+            }
+
+            bool animating() const { return Fl::has_timeout(tick, const_cast<BoardView*>(this)) != 0; }
+
+            bool flipped() const { return m_flipped; }
+            int squareSize() const { return m_size; }
+            int pieceAt(int square) const { return m_pieces[square]; }
+
+            /**
+             * @brief The square under a pixel in window coordinates, -1 outside the board
+             */
+            int squareAt(int px, int py) const {
+                int col = px - x(), row = py - y();
+                if (col < 0 || row < 0 || col >= w() || row >= h()) return -1;
+                col /= m_size;
+                row /= m_size;
+                return m_flipped ? row * 8 + 7 - col : (7 - row) * 8 + col;
+            }
+
+            /**
+             * @brief Draw the piece of a square centered on the pointer at (px, py) instead of
+             *        on its square, a square of -1 drops it back
+             */
+            void drag(int square, int px, int py) {
+                if (m_dragSquare >= 0) damageSprite(m_dragX, m_dragY);
+                if (square != m_dragSquare) invalidate(squareBit(square) | squareBit(m_dragSquare));
+                m_dragSquare = square;
+                m_dragX = px - m_size / 2;
+                m_dragY = py - m_size / 2;
+                if (square >= 0) damageSprite(m_dragX, m_dragY);
+            }
+
+            /**
+             * @brief Upper left pixel of a square in window coordinates
+             */
+            void squareOrigin(int square, int& sx, int& sy) const {
+                int col = m_flipped ? 7 - square % 8 : square % 8;
+                int row = m_flipped ? square / 8 : 7 - square / 8;
+                sx = x() + col * m_size;
+                sy = y() + row * m_size;
+            }
+
+            /**
+             * @brief Repaint these squares on the next draw
+             */
+            void invalidate(Bitboard squares) {
+                m_dirtySquares |= squares;
+                if (!m_widget) return;
+                while (squares) {
+                    int sx, sy;
+                    squareOrigin(popLsb(squares), sx, sy);
+                    m_widget->damage(FL_DAMAGE_USER1, sx, sy, m_size, m_size);
+                }
+            }
+
+        private:
+            /**
+             * @brief The hidden Fl_Widget that FLTK draws
+             */
+            class Canvas : public Fl_Widget{
+                public:
+                    explicit Canvas(BoardView& view) : Fl_Widget(view.x(), view.y(), view.w(), view.h()), m_view(view) {}
+                    void draw() override { m_view.paint(); }
+                private:
+                    BoardView& m_view; //!the view this draws
+            };
+
+            /**
+             * @brief One slot of the animation array
+             */
+            struct Animation {
+                enum Kind { NONE, SLIDE, FLASH };
+                Kind kind = NONE;
+                int piece = Piece::NONE;        // the sliding piece
+                int covered = Piece::NONE;      // shown on the target square until the piece arrives
+                int from = 0, to = 0;           // squares, a flash uses to
+                double start = 0, duration = 0; // seconds on the steady clock
+                Fl_Color color = 0;             // flash color
+                int x = 0, y = 0;               // where the sliding piece was last drawn
+            };
+
+            static double now() {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            Animation* freeSlot() {
+                for (Animation& a : m_animations) if (a.kind == Animation::NONE) return &a;
+                return nullptr;
+            }
+
+            void run() {
+                if (!Fl::has_timeout(tick, this)) Fl::add_timeout(FRAME_SECONDS, tick, this);
+            }
+
+            void slide(int piece, int from, int to, int covered) {
+                Animation* a = freeSlot();
+                if (!a || piece == Piece::NONE) return;
+                a->kind = Animation::SLIDE;
+                a->piece = piece;
+                a->covered = covered;
+                a->from = from;
+                a->to = to;
+                a->start = now();
+                a->duration = SLIDE_SECONDS;
+                squareOrigin(from, a->x, a->y);
+                m_hidden |= squareBit(to);
+                run();
+            }
+
+            void flash(int square, Fl_Color color, double delay) {
+                Animation* a = freeSlot();
+                if (!a) return;
+                a->kind = Animation::FLASH;
+                a->to = square;
+                a->color = color;
+                a->start = now() + delay;
+                a->duration = FLASH_SECONDS;
+                run();
+            }
+
+            static void tick(void* data) {
+                BoardView* view = static_cast<BoardView*>(data);
+                if (view->advance(now())) Fl::repeat_timeout(FRAME_SECONDS, tick, data);
+            }
+
+            static double progress(const Animation& a, double t) {
+                double p = (t - a.start) / a.duration;
+                return p < 0 ? 0 : p > 1 ? 1 : p;
+            }
+
+            // Move every animation to time t and damage what changed, true while any is left
+            bool advance(double t) {
+                bool running = false;
+                for (Animation& a : m_animations) {
+                    if (a.kind == Animation::NONE) continue;
+                    double p = progress(a, t);
+                    if (a.kind == Animation::SLIDE) {
+                        int fx, fy, tx, ty;
+                        squareOrigin(a.from, fx, fy);
+                        squareOrigin(a.to, tx, ty);
+                        double eased = 1 - (1 - p) * (1 - p);
+                        damageSprite(a.x, a.y);
+                        a.x = fx + static_cast<int>((tx - fx) * eased + 0.5);
+                        a.y = fy + static_cast<int>((ty - fy) * eased + 0.5);
+                        damageSprite(a.x, a.y);
+                        if (p >= 1) {
+                            m_hidden &= ~squareBit(a.to);
+                            a.kind = Animation::NONE;
+                        }
+                    } else if (t >= a.start) {
+                        invalidate(squareBit(a.to));
+                        if (p >= 1) a.kind = Animation::NONE;
+                    }
+                    running = running || a.kind != Animation::NONE;
+                }
+                return running;
+            }
+
+            // The squares under a piece drawn at (px, py) are repainted, clipped to its rectangle
+            void damageSprite(int px, int py) {
+                int col0 = (px - x()) / m_size, row0 = (py - y()) / m_size;
+                int col1 = (px - x() + m_size - 1) / m_size, row1 = (py - y() + m_size - 1) / m_size;
+                for (int row = row0; row <= row1 && row < 8; ++row) {
+                    for (int col = col0; col <= col1 && col < 8; ++col) {
+                        if (row < 0 || col < 0) continue;
+                        m_dirtySquares |= squareBit(m_flipped ? row * 8 + 7 - col : (7 - row) * 8 + col);
+                    }
+                }
+                if (m_widget) m_widget->damage(FL_DAMAGE_USER1, px, py, m_size, m_size);
+            }
+
+            static Bitboard squareBit(int square) { return square >= 0 ? 1ULL << square : 0; }
+            static Bitboard moveBits(const Move& move) { return move.isNull() ? 0 : squareBit(move.from()) | squareBit(move.to()); }
+
+            void paint() {
+                // only a damage of our own dirty squares may skip the rest of the board
+                unsigned char damage = m_widget->damage();
+                Fl_Window* window = m_widget->window();
+                bool full = damage != FL_DAMAGE_USER1 || (window && (window->damage() & ~FL_DAMAGE_CHILD));
+                Bitboard squares = full ? ~0ULL : m_dirtySquares;
+                m_dirtySquares = 0;
+
+                fl_push_clip(x(), y(), w(), h());
+                Fl_Color saved = fl_color();
+                const SpriteCache::Set* sprites = m_sprites ? &m_sprites->sprites(m_size) : nullptr;
+                m_frameTime = now();
+                while (squares) drawSquare(popLsb(squares), sprites);
+                for (const Animation& a : m_animations) {
+                    if (a.kind == Animation::SLIDE && fl_not_clipped(a.x, a.y, m_size, m_size)) drawSprite(a.piece, a.x, a.y, sprites);
+                }
+                if (m_dragSquare >= 0 && fl_not_clipped(m_dragX, m_dragY, m_size, m_size))
+                    drawSprite(m_pieces[m_dragSquare], m_dragX, m_dragY, sprites);
+                fl_color(saved);
+                fl_pop_clip();
+                m_widget->clear_damage();
+            }
+
+            void drawSquare(int square, const SpriteCache::Set* sprites) {
+                int sx, sy;
+                squareOrigin(square, sx, sy);
+                bool light = (square % 8 + square / 8) % 2 == 1;
+                Fl_Color color = light ? LIGHT : DARK;
+                if (square == m_check) color = fl_color_average(CHECK, color, 0.7f);
+                else if (square == m_selected) color = fl_color_average(SELECTED, color, 0.6f);
+                else if (moveBits(m_lastMove) & squareBit(square)) color = fl_color_average(SELECTED, color, 0.35f);
+                int piece = square == m_dragSquare ? Piece::NONE : m_pieces[square];
+                for (const Animation& a : m_animations) {
+                    if (a.to != square) continue;
+                    if (a.kind == Animation::FLASH && m_frameTime >= a.start)
+                        color = fl_color_average(a.color, color, static_cast<float>(0.7 * (1 - progress(a, m_frameTime))));
+                    else if (a.kind == Animation::SLIDE && (m_hidden & squareBit(square)))
+                        piece = a.covered;
+                }
+                fl_rectf(sx, sy, m_size, m_size, color);
+                drawSprite(piece, sx, sy, sprites);
+                if (m_targets & squareBit(square)) {
+                    fl_color(TARGET);
+                    if (piece != Piece::NONE) {
+                        fl_line_style(FL_SOLID, m_size / 16 > 1 ? m_size / 16 : 1);
+                        fl_arc(sx + 2, sy + 2, m_size - 4, m_size - 4, 0, 360);
+                        fl_line_style(FL_SOLID, 1);
+                    } else {
+                        fl_pie(sx + m_size * 3 / 8, sy + m_size * 3 / 8, m_size / 4, m_size / 4, 0, 360);
+                    }
+                }
+            }
+
+            void drawSprite(int piece, int px, int py, const SpriteCache::Set* sprites) {
+                if (piece != Piece::NONE && !(sprites && sprites->draw(piece, px, py))) drawPiece(piece, px, py);
+            }
+
+            // A disc with the piece letter, for pieces without an image
+            void drawPiece(int piece, int sx, int sy) {
+                bool white = Piece::isColor(piece, Piece::WHITE);
+                int inset = m_size / 8;
+                fl_color(white ? FL_WHITE : FL_BLACK);
+                fl_pie(sx + inset, sy + inset, m_size - 2 * inset, m_size - 2 * inset, 0, 360);
+                fl_color(white ? FL_BLACK : FL_WHITE);
+                fl_arc(sx + inset, sy + inset, m_size - 2 * inset, m_size - 2 * inset, 0, 360);
+                char letter[2] = {static_cast<char>(Piece::ToChar(piece) & ~0x20), '\0'};
+                fl_font(FL_HELVETICA_BOLD, m_size * 2 / 5);
+                fl_draw(letter, sx, sy, m_size, m_size, FL_ALIGN_CENTER);
+            }
+
+            static const Fl_Color LIGHT = 0xF0D9B500;   // RGB colors are 0xRRGGBB00
+            static const Fl_Color DARK = 0xB5886300;
+            static const Fl_Color SELECTED = 0xF6F66900;
+            static const Fl_Color CHECK = 0xE0303000;
+            static const Fl_Color TARGET = 0x40604000;
+
+            int m_size; //!width and height of one square in pixels
+            SpriteCache* m_sprites; //!piece images, null to draw discs
+            int m_pieces[64]; //!piece shown on every square
+            Move m_lastMove; //!highlighted last move, null for none
+            int m_selected; //!highlighted selected square, -1 for none
+            Bitboard m_targets; //!squares marked as targets of the selected piece
+            int m_check; //!square of a king in check, -1 for none
+            bool m_flipped; //!black at the bottom
+            Bitboard m_dirtySquares; //!squares to repaint on the next partial draw
+            Animation m_animations[MAX_ANIMATIONS]; //!running animations, kind NONE for a free slot
+            Bitboard m_hidden; //!target squares of sliding pieces, they show the covered piece meanwhile
+            double m_frameTime; //!time of the paint in progress
+            int m_dragSquare; //!square whose piece follows the pointer, -1 for none
+            int m_dragX, m_dragY; //!where the dragged piece is drawn
+    };
+}
+
+#endif
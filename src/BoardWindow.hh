@@ -0,0 +1,400 @@
+#ifndef BOARDWINDOW_HH__
+#define BOARDWINDOW_HH__
+
+#include "Window.hh"
+#include "GUI.hh"
+#include "Board.hh"
+#include "BoardView.hh"
+#include "GuiEngine.hh"
+#include "MoveHistory.hh"
+#include "Notation.hh"
+#include "Replay.hh"
+#include "SavedGame.hh"
+#include "cmath"
+#include <vector>
+/**
+ * @author Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief This class inherits from the AUGL::Window class and represents the chess board.
+ * @date 11/14/2024
+ */
+class BoardWindow : public AUGL::Window{
+    public:
+
+        static const int SQUARE_WIDTH = 100;
+        static const int PADDING = 50;
+        static const int PANEL_X = PADDING + SQUARE_WIDTH * 8 + 20;
+        static const int PANEL_WIDTH = 230;
+        static const int THINK_MS = 3000;
+        static const int CLOCK_MS = 15 * 60 * 1000;
+        static const int INCREMENT_MS = 10 * 1000;
+        static constexpr double CLOCK_SECONDS = 0.1;
+
+        /**
+         * @brief Open on a new game, or on a saved one if resume holds a loaded save
+         */
+        BoardWindow(AUGL::Point p,const std::string& title, const KS::SavedGame* resume = nullptr):
+        Window(p,SQUARE_WIDTH * 8 + 300, PADDING + SQUARE_WIDTH * 8,title),
+        m_engine([this](const KS::GuiEngine::Progress& progress){ showProgress(progress); }),
+        m_clock(CLOCK_MS, INCREMENT_MS){
+            m_settings.thinkMs = THINK_MS;
+            // after each engine move the engine keeps searching the reply it expects while the player thinks
+            m_engine.setPonder(true);
+            // one widget draws all 64 squares and repaints only the ones that change
+            m_board = new KS::BoardView({PADDING, 0}, SQUARE_WIDTH);
+            attach(*m_board);
+            m_sprites.sprites(SQUARE_WIDTH);  // scale the pieces now rather than on the first draw
+            m_board->setSprites(&m_sprites);
+            UpdateBoard(KS::Move());
+
+            m_newButton = new AUGL::Button({PANEL_X, 10}, PANEL_WIDTH / 2 - 5, 30, {"New game"}, newGameCallback);
+            attach(*m_newButton);
+            // the clocks start with the first move and run for whoever is to move
+            m_clockView = new AUGL::Output({PANEL_X + PANEL_WIDTH / 2 + 5, 10}, PANEL_WIDTH / 2 - 5, 30, {""});
+            attach(*m_clockView);
+
+            // engine panel, filled from the engine thread's progress once per frame
+            m_thinkButton = new AUGL::Button({PANEL_X, PADDING}, PANEL_WIDTH / 2 - 5, 30, {"Engine move"}, thinkCallback);
+            attach(*m_thinkButton);
+            m_stopButton = new AUGL::Button({PANEL_X + PANEL_WIDTH / 2 + 5, PADDING}, PANEL_WIDTH / 2 - 5, 30, {"Move now"}, stopCallback);
+            attach(*m_stopButton);
+            m_status = new AUGL::Output({PANEL_X, PADDING + 50}, PANEL_WIDTH, 25, {"White to move"});
+            attach(*m_status);
+            m_score = new AUGL::Output({PANEL_X, PADDING + 85}, PANEL_WIDTH, 25, {""});
+            attach(*m_score);
+            m_nodes = new AUGL::Output({PANEL_X, PADDING + 120}, PANEL_WIDTH, 25, {""});
+            attach(*m_nodes);
+            m_pv = new AUGL::Output({PANEL_X, PADDING + 155}, PANEL_WIDTH, 25, {""});
+            attach(*m_pv);
+
+            // the moves of the game, only the rows in view are drawn; a click or the scrubber shows an earlier position
+            m_history = new KS::MoveHistory({PANEL_X, PADDING + 195}, PANEL_WIDTH, SQUARE_WIDTH * 8 - 245);
+            attach(*m_history);
+            m_history->onSelect([this](int ply){ showPly(ply + 1); });
+            m_scrubber = new AUGL::Slider({PANEL_X, PADDING + SQUARE_WIDTH * 8 - 40}, PANEL_WIDTH, 20, scrubCallback);
+            attach(*m_scrubber);
+
+            if(resume != nullptr && resume->loaded()) restore(*resume);
+            showClock();
+        }
+
+        ~BoardWindow(){
+            Fl::remove_timeout(clockTick, this);
+        }
+
+        /**
+         * @brief Mouse input on the board moves the pieces, 'f' flips the board,
+         *        everything else goes to the panel widgets
+         *
+         * A piece can be clicked and then its target clicked, or dragged to the target.
+         * Only arithmetic and lookups in the cached legal moves happen here, so input
+         * stays fast while the engine searches.
+         */
+        int handle(int event) override{
+            switch(event){
+                case FL_PUSH:
+                case FL_DRAG:
+                case FL_RELEASE: {
+                    int square = m_board->squareAt(Fl::event_x(), Fl::event_y());
+                    if(event == FL_PUSH ? square < 0 : !m_dragging) break;
+                    boardMouse(event, square);
+                    return 1;
+                }
+                case FL_KEYDOWN:
+                    switch(Fl::event_key()){
+                        case 'f':
+                            m_board->setFlipped(!m_board->flipped());
+                            m_settings.flipped = m_board->flipped();
+                            save();
+                            return 1;
+                        case FL_Left: showPly(m_view - 1); return 1;
+                        case FL_Right: showPly(m_view + 1); return 1;
+                        case FL_Home: showPly(0); return 1;
+                        case FL_End: showPly(m_replay.plies()); return 1;
+                    }
+                    break;
+            }
+            return Window::handle(event);
+        }
+
+        /**
+         * @brief Let the engine find a move for the side to move, the window stays responsive meanwhile
+         */
+        void think(){
+            if(m_engine.thinking() || m_state != KS::Board::ONGOING) return;
+            select(-1);
+            KS::SearchLimits limits;
+            limits.movetime = m_settings.thinkMs;
+            bool hit = m_engine.go(m_position, limits);
+            m_status->put(hit ? "Thinking... (ponder hit)" : "Thinking...");
+        }
+
+        /**
+         * @brief Show the current position with the move that led to it highlighted
+         */
+        void UpdateBoard(const KS::Move& lastMove){
+            m_board->setPosition(m_position);
+            m_board->setLastMove(lastMove);
+            cacheLegalMoves();
+        }
+
+        /**
+         * @brief Show the position after a ply of the game, moves can only be made at the last ply
+         */
+        void showPly(int ply){
+            if(ply < 0) ply = 0;
+            if(ply > m_replay.plies()) ply = m_replay.plies();
+            if(ply == m_view) return;
+            m_view = ply;
+            select(-1);
+            m_board->finishAnimations();
+            int plies = m_replay.plies();
+            m_board->setPosition(m_replay.seek(ply));
+            if(m_replay.plies() < plies) return cutGame();
+            m_board->setLastMove(ply > 0 ? m_replay.move(ply - 1) : KS::Move());
+            m_history->setCurrent(live() ? -1 : ply - 1);
+            m_scrubber->setValue(ply);
+        }
+
+        bool live() const { return m_view == m_replay.plies(); }
+
+        /**
+         * @brief Drop the game and start from the initial position
+         */
+        void newGame(){
+            m_engine.cancel();
+            m_board->finishAnimations();
+            m_position = KS::Board();
+            m_replay.reset(m_position);
+            m_history->clear();
+            m_view = 0;
+            m_clock.reset(CLOCK_MS, INCREMENT_MS);
+            showClock();
+            m_scrubber->setRange(0, 0);
+            m_scrubber->setValue(0);
+            select(-1);
+            UpdateBoard(KS::Move());
+            m_status->put(statusText());
+            save();
+        }
+    private:
+        // Continue a saved game: the last position is stored, no move is replayed
+        void restore(const KS::SavedGame& saved){
+            if(!saved.restore(m_replay, m_position, m_clock, m_settings)){
+                m_clock.reset(CLOCK_MS, INCREMENT_MS);
+                m_position = KS::Board();
+                m_replay.reset(m_position);
+                return;
+            }
+            if(saved.san() != nullptr){
+                m_history->restore(saved.san(), saved.sanStarts(), saved.plies());
+            } else {
+                KS::Board board = m_replay.start();
+                for(const KS::Move& move : m_replay.moves()){
+                    m_history->push(KS::Notation::san(board, move));
+                    KS::Board::Undo u;
+                    board.makeMove(move, u);
+                }
+            }
+            // saves from before the window kept time have both clocks at zero
+            const KS::SavedGame::Clocks& clocks = saved.clocks();
+            if(clocks.remainingMs[0] <= 0 && clocks.remainingMs[1] <= 0) m_clock.reset(CLOCK_MS, INCREMENT_MS);
+            m_view = m_replay.plies();
+            m_scrubber->setRange(0, m_view);
+            m_scrubber->setValue(m_view);
+            m_board->setFlipped(m_settings.flipped != 0);
+            UpdateBoard(m_view > 0 ? m_replay.move(m_view - 1) : KS::Move());
+            m_status->put(statusText());
+            // the save holds both clocks stopped; the side to move's runs again if it was running
+            if(saved.clocks().running >= 0 && m_state == KS::Board::ONGOING) startClock();
+        }
+
+        // A restored move turned out illegal and Replay dropped the game from it on: continue from there
+        void cutGame(){
+            m_board->finishAnimations();
+            m_view = m_replay.plies();
+            m_history->truncate(m_view);
+            m_history->setCurrent(-1);
+            m_position = m_replay.seek(m_view);
+            m_scrubber->setRange(0, m_view);
+            m_scrubber->setValue(m_view);
+            select(-1);
+            UpdateBoard(m_view > 0 ? m_replay.move(m_view - 1) : KS::Move());
+            m_status->put("Saved game cut at ply " + std::to_string(m_view) + ", " + statusText());
+            save();
+        }
+
+        // Written after every move so a restart reopens on the game
+        void save(){
+            KS::SavedGame::save(KS::SavedGame::defaultPath(), m_replay, m_position, m_clock, m_settings, m_history->arena(), m_history->starts());
+        }
+
+        void startClock(){
+            m_clock.start(m_position.sideToMove());
+            if(!Fl::has_timeout(clockTick, this)) Fl::add_timeout(CLOCK_SECONDS, clockTick, this);
+        }
+
+        void showClock(){
+            m_clockView->put("W " + m_clock.format(KS::Piece::WHITE) + "  B " + m_clock.format(KS::Piece::BLACK));
+        }
+
+        // Redraws the clocks while one runs; a side out of time is shown but may still move
+        static void clockTick(void* data){
+            BoardWindow* self = static_cast<BoardWindow*>(data);
+            self->showClock();
+            if(self->m_clock.running()) Fl::repeat_timeout(CLOCK_SECONDS, clockTick, data);
+        }
+
+        /**
+         * @brief Show the engine's progress, called on the UI thread at most once per frame
+         */
+        void showProgress(const KS::GuiEngine::Progress& progress){
+            m_score->put("Depth " + std::to_string(progress.depth) + "   " + progress.scoreString());
+            m_nodes->put(std::to_string(progress.nodes) + " nodes, " + std::to_string(progress.timeMs) + " ms");
+            m_pv->put(progress.pvString());
+            if(!progress.done) return;
+            if(progress.best.isNull() || !m_position.isLegal(progress.best)) return;
+            play(progress.best, true);
+            // the engine now ponders this reply; playing it and asking for a move is a ponder hit
+            if(m_state == KS::Board::ONGOING && !progress.ponder.isNull() && m_position.isLegal(progress.ponder)){
+                m_status->put(statusText() + ", engine expects " + KS::Notation::san(m_position, progress.ponder));
+            }
+        }
+
+        /**
+         * @brief Generate the legal moves once per position and keep their targets per square
+         */
+        void cacheLegalMoves(){
+            if(m_position.zobrist() == m_legalKey && m_legal.size() > 0) return;
+            m_legalKey = m_position.zobrist();
+            m_position.generateLegalMoves(m_legal);
+            for(KS::Bitboard& targets : m_targets) targets = 0;
+            for(const KS::Move& move : m_legal) m_targets[move.from()] |= 1ULL << move.to();
+            m_state = m_position.gameState();
+        }
+
+        void select(int square){
+            if(square < 0 && m_dragging){
+                // a key or the scrubber moved away from the position mid-drag
+                m_dragging = false;
+                m_board->drag(-1, 0, 0);
+            }
+            m_selected = square;
+            m_board->setSelected(square);
+            m_board->setTargets(square >= 0 ? m_targets[square] : 0);
+        }
+
+        void boardMouse(int event, int square){
+            if(event == FL_PUSH){
+                m_dragging = false;
+                if(m_selected >= 0 && (m_targets[m_selected] & (1ULL << square))){
+                    playUserMove(m_selected, square, true);
+                } else if(live() && !m_engine.thinking() && m_state == KS::Board::ONGOING &&
+                          KS::Piece::isColor(m_position.pieceAt(square), m_position.sideToMove())){
+                    select(square);
+                    m_dragging = true;
+                    m_board->drag(square, Fl::event_x(), Fl::event_y());
+                } else {
+                    select(-1);
+                }
+            } else if(event == FL_DRAG){
+                if(m_selected >= 0) m_board->drag(m_selected, Fl::event_x(), Fl::event_y());
+            } else {
+                m_dragging = false;
+                m_board->drag(-1, 0, 0);
+                if(square >= 0 && m_selected >= 0 && (m_targets[m_selected] & (1ULL << square))) playUserMove(m_selected, square, false);
+            }
+        }
+
+        // A dropped piece is already on its square, a clicked move slides
+        void playUserMove(int from, int to, bool animate){
+            KS::Move chosen;
+            for(const KS::Move& move : m_legal){
+                if(move.from() != from || move.to() != to) continue;
+                chosen = move;
+                if(!move.isPromotion() || move.promotionType() == KS::Piece::QUEEN) break;
+            }
+            play(chosen, animate);
+            m_engine.opponentMoved(m_position);
+        }
+
+        void play(const KS::Move& move, bool animate){
+            if(!live()){
+                showPly(m_replay.plies());
+                animate = false;
+            }
+            if(animate) m_board->animateMove(m_position, move);
+            m_history->push(KS::Notation::san(m_position, move));
+            int plies = m_replay.plies();
+            m_replay.push(move);
+            if(m_replay.plies() <= plies) return cutGame();
+            m_view = m_replay.plies();
+            m_scrubber->setRange(0, m_view);
+            m_scrubber->setValue(m_view);
+            KS::Board::Undo u;
+            m_position.makeMove(move, u);
+            select(-1);
+            UpdateBoard(move);
+            if(m_state != KS::Board::ONGOING) m_clock.stop();
+            else if(m_clock.running()) m_clock.press();
+            else startClock();
+            showClock();
+            m_status->put(statusText());
+            save();
+        }
+
+        std::string statusText() const{
+            switch(m_state){
+                case KS::Board::CHECKMATE: return m_position.sideToMove() == KS::Piece::WHITE ? "Black wins by checkmate" : "White wins by checkmate";
+                case KS::Board::STALEMATE: return "Draw by stalemate";
+                case KS::Board::REPETITION: return "Draw by repetition";
+                case KS::Board::FIFTY_MOVES: return "Draw by the fifty-move rule";
+                case KS::Board::INSUFFICIENT_MATERIAL: return "Draw by insufficient material";
+                default: return m_position.sideToMove() == KS::Piece::WHITE ? "White to move" : "Black to move";
+            }
+        }
+
+        static void thinkCallback(Address_t, Address_t window){
+            static_cast<BoardWindow*>(window)->think();
+        }
+
+        static void stopCallback(Address_t, Address_t window){
+            static_cast<BoardWindow*>(window)->m_engine.moveNow();
+        }
+
+        static void newGameCallback(Address_t, Address_t window){
+            static_cast<BoardWindow*>(window)->newGame();
+        }
+
+        static void scrubCallback(Address_t, Address_t window){
+            BoardWindow* self = static_cast<BoardWindow*>(window);
+            self->showPly(self->m_scrubber->value());
+        }
+
+        KS::Board m_position; //!the game being played, with its history for repetitions
+        KS::GuiEngine m_engine; //!searches on its own thread and reports through showProgress
+        KS::SpriteCache m_sprites; //!piece images decoded once, shared by every draw
+        KS::BoardView* m_board; //!the squares and pieces
+        AUGL::Button* m_newButton; //!starts over
+        AUGL::Output* m_clockView; //!time left of both sides
+        AUGL::Button* m_thinkButton; //!starts the engine on the side to move
+        AUGL::Button* m_stopButton; //!makes the engine play its best move so far
+        AUGL::Output* m_status; //!whose turn it is or what the engine played
+        AUGL::Output* m_score; //!depth and score of the last completed iteration
+        AUGL::Output* m_nodes; //!nodes and time spent
+        AUGL::Output* m_pv; //!the line the engine expects
+        KS::MoveHistory* m_history; //!moves played so far
+        AUGL::Slider* m_scrubber; //!picks the ply shown
+        KS::Replay m_replay; //!the moves of the game, for showing earlier positions
+        int m_view = 0; //!ply shown on the board, m_replay.plies() when following the game
+        KS::SavedGame::Settings m_settings; //!engine time and board orientation, saved with the game
+        KS::GameClock m_clock; //!time left of both sides, saved with the game
+        KS::MoveList m_legal; //!legal moves of m_position
+        KS::Bitboard m_targets[64] = {}; //!target squares of the legal moves by from square
+        uint64_t m_legalKey = 0; //!position the legal moves belong to
+        KS::Board::GameState m_state = KS::Board::ONGOING; //!result of m_position
+        int m_selected = -1; //!square of the selected piece, -1 for none
+        bool m_dragging = false; //!the selected piece follows the mouse
+
+};
+
+#endif
@@ -1,110 +1,72 @@
 #include <iostream>
-#include <vector>
 #include <string>
-#include "BoardWindow.hh" // Assuming BoardWindow is the UI class you mentioned
-
-class ChessGame {
-public:
-    // Representing the board as an 8x8 grid with pieces
-    // Each cell holds a character, with 'P' for Pawn, 'R' for Rook, etc.
-    // Uppercase for White pieces, lowercase for Black pieces
-    char board[8][8];
-
-    ChessGame() {
-        // Initialize the chessboard with the standard starting positions
-        resetBoard();
-    }
-
-    // Reset the board to the starting position
-    void resetBoard() {
-        const std::string initialBoard[8] = {
-            "RNBQKBNR", // Black pieces
-            "PPPPPPPP", // Black pawns
-            "        ",  // Empty row
-            "        ",  // Empty row
-            "        ",  // Empty row
-            "        ",  // Empty row
-            "pppppppp",  // White pawns
-            "rnbqkbnr"   // White pieces
-        };
+#include "Analyzer.hh"
+#include "Bench.hh"
+#include "Uci.hh"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+
+// The whole of text as a whole number between min and max
+bool parseNumber(const std::string& text, long min, long max, long& n) {
+    char* end;
+    errno = 0;
+    n = std::strtol(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+}
 
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                board[i][j] = initialBoard[i][j];
-            }
+// analyze [file] [--threads N] [--depth N] [--nodes N] [--movetime ms] [--hash MB] [--multipv N]
+// Reads FEN lines from the file or stdin and writes JSON lines to stdout
+int analyze(int argc, char** argv) {
+    KS::Analyzer::Options options;
+    std::string path;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) { path = arg; continue; }
+        std::string value = i + 1 < argc ? argv[++i] : "";
+        long n = 0;
+        if (arg == "--threads" && parseNumber(value, 1, 256, n)) options.threads = static_cast<unsigned>(n);
+        else if (arg == "--depth" && parseNumber(value, 1, KS::Search::MAX_PLY - 1, n)) options.limits.depth = static_cast<int>(n);
+        else if (arg == "--nodes" && parseNumber(value, 1, LONG_MAX, n)) options.limits.nodes = static_cast<uint64_t>(n);
+        else if (arg == "--movetime" && parseNumber(value, 1, LONG_MAX, n)) options.limits.movetime = n;
+        else if (arg == "--hash" && parseNumber(value, 1, 65536, n)) options.hashMb = static_cast<size_t>(n);
+        else if (arg == "--multipv" && parseNumber(value, 1, 64, n)) options.multiPV = static_cast<int>(n);
+        else {
+            std::cerr << "Usage: " << argv[0] << " analyze [file] [--threads N] [--depth N] [--nodes N] [--movetime ms] [--hash MB] [--multipv N]" << std::endl;
+            return 1;
         }
     }
 
-    // Print the current state of the board
-    void printBoard() {
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 8; j++) {
-                std::cout << board[i][j] << " ";
-            }
-            std::cout << std::endl;
-        }
+    KS::Analyzer analyzer(options);
+    if (path.empty() || path == "-") {
+        analyzer.run(std::cin);
+        return 0;
     }
-
-    // Move a piece from one square to another (e.g., "e2" to "e4")
-    bool movePiece(const std::string& from, const std::string& to) {
-        int fromRow = 8 - (from[1] - '0'); // Convert from chess notation to array index
-        int fromCol = from[0] - 'a';
-        int toRow = 8 - (to[1] - '0');
-        int toCol = to[0] - 'a';
-
-        // Check if the move is within bounds and if the starting square has a piece
-        if (fromRow < 0 || fromRow >= 8 || fromCol < 0 || fromCol >= 8 ||
-            toRow < 0 || toRow >= 8 || toCol < 0 || toCol >= 8 || board[fromRow][fromCol] == ' ') {
-            std::cout << "Invalid move!" << std::endl;
-            return false;
-        }
-
-        // Move the piece
-        board[toRow][toCol] = board[fromRow][fromCol];
-        board[fromRow][fromCol] = ' '; // Empty the starting square
-        return true;
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
     }
+    analyzer.run(in);
+    return 0;
+}
 
-    // Check if a move is valid (simplified version)
-    bool isValidMove(const std::string& from, const std::string& to) {
-        // For simplicity, this function can be expanded based on chess rules
-        // Currently, it only checks if the move is within bounds
-        int fromRow = 8 - (from[1] - '0');
-        int fromCol = from[0] - 'a';
-        int toRow = 8 - (to[1] - '0');
-        int toCol = to[0] - 'a';
-        return fromRow >= 0 && fromRow < 8 && fromCol >= 0 && fromCol < 8 &&
-               toRow >= 0 && toRow < 8 && toCol >= 0 && toCol < 8;
-    }
-};
-
-int main() {
-    ChessGame game;
-
-    // Create and display the game window
-    BoardWindow window({100, 100}, "Chess");
-    window.show();
-
-    game.printBoard(); // Print the initial board state
-
-    std::string from, to;
-    while (true) {
-        std::cout << "Enter move (e.g., 'e2 e4'): ";
-        std::cin >> from >> to;
-
-        if (game.isValidMove(from, to)) {
-            if (game.movePiece(from, to)) {
-                game.printBoard();
-            } else {
-                std::cout << "Move failed!" << std::endl;
-            }
-        } else {
-            std::cout << "Invalid move!" << std::endl;
+// Headless engine: speaks UCI on stdin/stdout so tournament managers and scripts can drive it,
+// annotates positions in batch with "analyze", or prints the node signature with "bench [depth]"
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "analyze") return analyze(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        long depth = KS::Bench::DEFAULT_DEPTH;
+        if (argc > 3 || (argc == 3 && !parseNumber(argv[2], 1, KS::Search::MAX_PLY - 1, depth))) {
+            std::cerr << "Usage: " << argv[0] << " bench [depth]" << std::endl;
+            return 1;
         }
-
-        // Update the window with the new board state
-        // You would need to update the board window here based on the `game.board`
+        KS::Bench::run(static_cast<int>(depth));
+        return 0;
     }
 
+    KS::Uci uci;
+    uci.loop();
     return 0;
 }
@@ -0,0 +1,207 @@
+#include "Board.hh"
+#include "RingBuffer.hh"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Throughput of the server's move path as threads are added, for three ways to share the games
+ *
+ *   ContentionBench [--threads 1,2,4,...] [--sessions N] [--seconds S]
+ *
+ *   global    every thread looks the game up in one table under one mutex and plays the move
+ *   striped   the same with one mutex per shard of the table, one shard per thread
+ *   mailbox   half the threads post moves to the games' lock-free mailboxes, the other
+ *             half own the games and play them, as GameServer does; it needs one of each,
+ *             so it shows "-" for a single thread
+ *
+ * Every column of a row runs the same number of threads.
+ *
+ * A move is a make and unmake on the game's Board, so the time in the lock is short and
+ * the cost of sharing shows. Reported in millions of moves per second; a curve that
+ * stays flat as threads are added is contention.
+ */
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    const size_t MAILBOX = 32;
+
+    struct Options {
+        std::vector<unsigned> threads;
+        unsigned sessions = 1024;
+        double seconds = 0.5;
+    };
+
+    struct Session {
+        KS::Board board;
+        uint64_t played = 0;
+
+        void play(const KS::Move& move) {
+            KS::Board::Undo u;
+            board.makeMove(move, u);
+            board.unmakeMove(move, u);
+            ++played;
+        }
+    };
+
+    // A legal move from the start position for every game
+    KS::Move firstMove() {
+        KS::Board board;
+        KS::MoveList moves;
+        board.generateLegalMoves(moves);
+        return moves[0];
+    }
+
+    // Run threads until the time is up and return the moves per second they played
+    double timed(const Options& opt, unsigned count, const std::function<uint64_t(unsigned, const std::atomic<bool>&)>& body) {
+        std::atomic<bool> stop(false);
+        std::vector<uint64_t> played(count);
+        std::vector<std::thread> threads;
+        Clock::time_point start = Clock::now();
+        for (unsigned t = 0; t < count; ++t) threads.emplace_back([&, t]() { played[t] = body(t, stop); });
+        std::this_thread::sleep_for(std::chrono::duration<double>(opt.seconds));
+        stop = true;
+        for (auto& t : threads) t.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        uint64_t total = 0;
+        for (uint64_t p : played) total += p;
+        return total / seconds;
+    }
+
+    double locked(const Options& opt, unsigned threads, unsigned shardCount) {
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            std::unordered_map<uint32_t, Session> games;
+        };
+        std::vector<Shard> shards(shardCount);
+        for (uint32_t id = 0; id < opt.sessions; ++id) shards[id % shardCount].games[id];
+        const KS::Move move = firstMove();
+        return timed(opt, threads, [&](unsigned self, const std::atomic<bool>& stop) {
+            std::mt19937 random(self + 1);
+            uint64_t played = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint32_t id = random() % opt.sessions;
+                Shard& shard = shards[id % shardCount];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.games.find(id)->second.play(move);
+                ++played;
+            }
+            return played;
+        });
+    }
+
+    double mailbox(const Options& opt, unsigned threads) {
+        struct Game {
+            KS::MpscRing<KS::Move, MAILBOX> mailbox;
+            std::atomic<bool> scheduled{false};
+            Session session;
+        };
+        typedef KS::MpscRing<uint32_t, 1 << 16> RunQueue;
+        unsigned producers = threads / 2, workers = threads - producers;
+        std::vector<std::unique_ptr<Game>> games;
+        for (unsigned i = 0; i < opt.sessions; ++i) games.emplace_back(new Game());
+        std::vector<std::unique_ptr<RunQueue>> queues;
+        for (unsigned w = 0; w < workers; ++w) queues.emplace_back(new RunQueue());
+        const KS::Move move = firstMove();
+        return timed(opt, producers + workers, [&](unsigned self, const std::atomic<bool>& stop) -> uint64_t {
+            if (self < producers) {
+                std::mt19937 random(self + 1);
+                while (!stop.load(std::memory_order_relaxed)) {
+                    uint32_t id = random() % opt.sessions;
+                    Game& g = *games[id];
+                    if (!g.mailbox.push(move)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (!g.scheduled.exchange(true, std::memory_order_acq_rel)) queues[id % workers]->push(id);
+                }
+                return 0;
+            }
+            RunQueue& queue = *queues[self - producers];
+            uint64_t played = 0;
+            uint32_t id;
+            KS::Move m;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!queue.pop(id)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                Game& g = *games[id];
+                for (size_t taken = 0; taken < MAILBOX && g.mailbox.pop(m); ++taken, ++played) g.session.play(m);
+                g.scheduled.exchange(false, std::memory_order_acq_rel);
+                if (!g.mailbox.empty() && !g.scheduled.exchange(true, std::memory_order_acq_rel)) queue.push(id);
+            }
+            return played;
+        });
+    }
+
+    // The whole of text as a whole number between min and max
+    bool parseNumber(const std::string& text, long min, long max, long& n) {
+        char* end;
+        errno = 0;
+        n = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string flag = argv[i], value = argv[i + 1];
+            long n = 0;
+            if (flag == "--threads") {
+                for (size_t start = 0; start <= value.size();) {
+                    size_t comma = std::min(value.find(',', start), value.size());
+                    if (!parseNumber(value.substr(start, comma - start), 1, 1024, n)) return false;
+                    opt.threads.push_back(static_cast<unsigned>(n));
+                    start = comma + 1;
+                }
+            }
+            else if (flag == "--sessions" && parseNumber(value, 1, 1 << 16, n)) opt.sessions = static_cast<unsigned>(n);
+            else if (flag == "--seconds") {
+                char* end;
+                opt.seconds = std::strtod(value.c_str(), &end);
+                if (value.empty() || *end != '\0' || !(opt.seconds > 0 && opt.seconds <= 3600)) return false;
+            }
+            else return false;
+        }
+        if (opt.threads.empty()) {
+            unsigned cores = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+            for (unsigned t = 1; t <= std::max(4u, 2 * cores); t *= 2) opt.threads.push_back(t);
+        }
+        return argc % 2 == 1;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [--threads 1,2,4,...] [--sessions N (at most 65536)] [--seconds S]" << std::endl;
+        return 1;
+    }
+
+    std::cout << opt.sessions << " games, " << std::thread::hardware_concurrency() << " cores, million moves per second\n"
+              << std::setw(8) << "threads" << std::setw(12) << "global" << std::setw(12) << "striped" << std::setw(12) << "mailbox" << std::endl;
+    for (unsigned threads : opt.threads) {
+        double global = locked(opt, threads, 1);
+        double striped = locked(opt, threads, threads);
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2) << std::setw(12) << global / 1e6
+                  << std::setw(12) << striped / 1e6 << std::setw(12);
+        if (threads >= 2) std::cout << mailbox(opt, threads) / 1e6 << std::endl;
+        else std::cout << "-" << std::endl;
+    }
+    return 0;
+}
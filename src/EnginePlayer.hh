@@ -0,0 +1,182 @@
+#ifndef ENGINEPLAYER_HH__
+#define ENGINEPLAYER_HH__
+
+#include "Board.hh"
+#include "Search.hh"
+#include "TranspositionTable.hh"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief The engine as a game opponent that keeps thinking on the opponent's time
+     *
+     * go() searches on a background thread and reports the move through a callback.
+     * With pondering on, the same thread then searches the position after the reply
+     * the search expects. If the opponent plays that reply, the next go() turns the
+     * running search into a normal timed one (a ponder hit) and keeps all the work
+     * done so far; any other reply stops it and starts a fresh search. The hash table
+     * is kept between moves either way.
+     */
+    class EnginePlayer{
+        public:
+            // Called on the engine thread with the chosen move and the expected reply (null if none);
+            // it must not call back into the EnginePlayer
+            typedef std::function<void(Move best, Move ponder)> MoveCallback;
+            // Called on the engine thread after every iteration, same rules as MoveCallback
+            typedef Search::InfoCallback InfoCallback;
+
+            explicit EnginePlayer(size_t hashMb = 16)
+                : m_tt(hashMb), m_search(m_tt), m_ponder(false), m_cancelled(false), m_pondering(false), m_hit(false), m_ponderKey(0) {}
+
+            ~EnginePlayer() { cancel(); }
+
+            void setPonder(bool ponder) { m_ponder = ponder; }
+            void setThreads(int threads) {
+                cancel();
+                m_search.setThreads(threads);
+            }
+
+            /**
+             * @brief Forget the previous game
+             */
+            void newGame() {
+                cancel();
+                m_tt.clear();
+            }
+
+            /**
+             * @brief Find a move for the side to move, onMove is called when it is found
+             *
+             * The position must include the game history (made with makeMove) so the search
+             * sees repetitions. onInfo, if given, receives the progress of the search.
+             * Returns true on a ponder hit: the running ponder search goes on as this search.
+             */
+            bool go(const Board& position, const SearchLimits& limits, MoveCallback onMove, InfoCallback onInfo = nullptr) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_pondering && position.zobrist() == m_ponderKey) {
+                        m_onMove = onMove;
+                        m_onInfo = onInfo;
+                        m_hit = true;
+                        m_search.ponderhit();
+                        return true;
+                    }
+                }
+                cancel();
+                m_onMove = onMove;
+                m_onInfo = onInfo;
+                m_search.prepare(limits.ponder);
+                m_thread = std::thread([this, position, limits]() { run(position, limits); });
+                return false;
+            }
+
+            /**
+             * @brief The opponent moved: a ponder search on another position is told to stop,
+             *        without waiting for it, so the next go() finds the thread already done
+             */
+            void opponentMoved(const Board& position) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_pondering && position.zobrist() != m_ponderKey) m_search.stop();
+            }
+
+            /**
+             * @brief Stop searching or pondering and wait for the engine thread, no callback follows
+             */
+            void cancel() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_cancelled = true;
+                }
+                m_search.stop();
+                if (m_thread.joinable()) m_thread.join();
+                m_cancelled = false;
+                m_pondering = false;
+            }
+
+            /**
+             * @brief True while searching the expected reply on the opponent's time
+             */
+            bool pondering() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_pondering;
+            }
+
+            Search& search() { return m_search; }
+
+        private:
+            static int64_t nowMs() {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            void run(Board position, SearchLimits limits) {
+                // go() may swap the callback on a ponder hit while the search runs
+                Search::InfoCallback report = [this](const SearchInfo& info) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_cancelled && m_onInfo) m_onInfo(info);
+                };
+                int64_t start = nowMs();
+                Move best = m_search.think(position, limits, report);
+                for (;;) {
+                    Move reply = m_search.ponderMove();
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (m_cancelled) return;
+                        if (m_onMove) m_onMove(best, reply);
+                    }
+
+                    // the position after the expected reply, with our clock as it will be then
+                    if (!m_ponder || best.isNull() || reply.isNull()) return;
+                    int us = Piece::ColorIndex(position.sideToMove());
+                    Board::Undo u;
+                    position.makeMove(best, u);
+                    if (!position.isLegal(reply)) return;
+                    position.makeMove(reply, u);
+                    if (position.gameState() != Board::ONGOING) return;
+                    if (limits.time[us] >= 0) {
+                        limits.time[us] -= nowMs() - start;
+                        limits.time[us] += limits.inc[us];
+                        if (limits.time[us] < 1) limits.time[us] = 1;
+                    }
+                    limits.ponder = true;
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (m_cancelled) return;
+                        m_search.prepare(true);
+                        m_ponderKey = position.zobrist();
+                        m_pondering = true;
+                        m_hit = false;
+                    }
+                    best = m_search.think(position, limits, report);
+                    start = nowMs() - m_search.result().timeMs;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_pondering = false;
+                        if (!m_hit) return;  // the opponent played something else
+                    }
+                    limits.ponder = false;
+                }
+            }
+
+            TranspositionTable m_tt; //!kept warm between moves
+            Search m_search; //!searches and ponders, one at a time
+            std::thread m_thread; //!runs the current search and the ponder search after it
+            mutable std::mutex m_mutex; //!guards the fields below against go() and cancel()
+            MoveCallback m_onMove; //!receives the next move
+            InfoCallback m_onInfo; //!receives the progress of the search
+            std::atomic<bool> m_ponder; //!ponder after each move
+            bool m_cancelled; //!the running search must not report
+            bool m_pondering; //!a ponder search is running
+            bool m_hit; //!the opponent played the expected reply
+            uint64_t m_ponderKey; //!position the ponder search is on
+    };
+}
+
+#endif
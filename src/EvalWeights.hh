@@ -0,0 +1,184 @@
+// Hand-written starting weights in the layout the Tuner writes.
+// Regenerate it with the tuner rather than editing it by hand.
+#ifndef EVALWEIGHTS_HH__
+#define EVALWEIGHTS_HH__
+
+namespace KS{
+
+    /**
+     * @brief Middlegame and endgame weight of every Evaluation term, in Evaluation's term order
+     */
+    struct EvalWeights{
+        static constexpr int MG[] = {
+            // material by piece type
+               0,    0,   82,  337,    0,  365,  477, 1025,
+            // piece-square table (unused), A1 first
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: king, A1 first
+              20,   30,   10,    0,    0,   10,   30,   20,
+              20,   20,    0,    0,    0,    0,   20,   20,
+             -10,  -20,  -20,  -20,  -20,  -20,  -20,  -10,
+             -20,  -30,  -30,  -40,  -40,  -30,  -30,  -20,
+             -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+             -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+             -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+             -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+            // piece-square table: pawn, A1 first
+               0,    0,    0,    0,    0,    0,    0,    0,
+               5,   10,   10,  -20,  -20,   10,   10,    5,
+               5,   -5,  -10,    0,    0,  -10,   -5,    5,
+               0,    0,    0,   20,   20,    0,    0,    0,
+               5,    5,   10,   25,   25,   10,    5,    5,
+              10,   10,   20,   30,   30,   20,   10,   10,
+              50,   50,   50,   50,   50,   50,   50,   50,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: knight, A1 first
+             -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+             -40,  -20,    0,    5,    5,    0,  -20,  -40,
+             -30,    5,   10,   15,   15,   10,    5,  -30,
+             -30,    0,   15,   20,   20,   15,    0,  -30,
+             -30,    5,   15,   20,   20,   15,    5,  -30,
+             -30,    0,   10,   15,   15,   10,    0,  -30,
+             -40,  -20,    0,    0,    0,    0,  -20,  -40,
+             -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+            // piece-square table (unused), A1 first
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: bishop, A1 first
+             -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+             -10,    5,    0,    0,    0,    0,    5,  -10,
+             -10,   10,   10,   10,   10,   10,   10,  -10,
+             -10,    0,   10,   10,   10,   10,    0,  -10,
+             -10,    5,    5,   10,   10,    5,    5,  -10,
+             -10,    0,    5,   10,   10,    5,    0,  -10,
+             -10,    0,    0,    0,    0,    0,    0,  -10,
+             -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+            // piece-square table: rook, A1 first
+               0,    0,    0,    5,    5,    0,    0,    0,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+               5,   10,   10,   10,   10,   10,   10,    5,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: queen, A1 first
+             -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+             -10,    0,    5,    0,    0,    0,    0,  -10,
+             -10,    5,    5,    5,    5,    5,    0,  -10,
+               0,    0,    5,    5,    5,    5,    0,   -5,
+              -5,    0,    5,    5,    5,    5,    0,   -5,
+             -10,    0,    5,    5,    5,    5,    0,  -10,
+             -10,    0,    0,    0,    0,    0,    0,  -10,
+             -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+            // mobility per attacked square by piece type
+               0,    0,    0,    4,    0,    5,    2,    1,
+            // doubled pawn, isolated pawn
+             -10,  -10,
+            // passed pawn by relative rank
+               0,    5,   10,   20,   35,   60,  100,    0,
+            // bishop pair
+              30,
+        };
+
+        static constexpr int EG[] = {
+            // material by piece type
+               0,    0,   94,  281,    0,  297,  512,  936,
+            // piece-square table (unused), A1 first
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: king, A1 first
+             -50,  -30,  -30,  -30,  -30,  -30,  -30,  -50,
+             -30,  -30,    0,    0,    0,    0,  -30,  -30,
+             -30,  -10,   20,   30,   30,   20,  -10,  -30,
+             -30,  -10,   30,   40,   40,   30,  -10,  -30,
+             -30,  -10,   30,   40,   40,   30,  -10,  -30,
+             -30,  -10,   20,   30,   30,   20,  -10,  -30,
+             -30,  -20,  -10,    0,    0,  -10,  -20,  -30,
+             -50,  -40,  -30,  -20,  -20,  -30,  -40,  -50,
+            // piece-square table: pawn, A1 first
+               0,    0,    0,    0,    0,    0,    0,    0,
+               5,   10,   10,  -20,  -20,   10,   10,    5,
+               5,   -5,  -10,    0,    0,  -10,   -5,    5,
+               0,    0,    0,   20,   20,    0,    0,    0,
+               5,    5,   10,   25,   25,   10,    5,    5,
+              10,   10,   20,   30,   30,   20,   10,   10,
+              50,   50,   50,   50,   50,   50,   50,   50,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: knight, A1 first
+             -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+             -40,  -20,    0,    5,    5,    0,  -20,  -40,
+             -30,    5,   10,   15,   15,   10,    5,  -30,
+             -30,    0,   15,   20,   20,   15,    0,  -30,
+             -30,    5,   15,   20,   20,   15,    5,  -30,
+             -30,    0,   10,   15,   15,   10,    0,  -30,
+             -40,  -20,    0,    0,    0,    0,  -20,  -40,
+             -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+            // piece-square table (unused), A1 first
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: bishop, A1 first
+             -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+             -10,    5,    0,    0,    0,    0,    5,  -10,
+             -10,   10,   10,   10,   10,   10,   10,  -10,
+             -10,    0,   10,   10,   10,   10,    0,  -10,
+             -10,    5,    5,   10,   10,    5,    5,  -10,
+             -10,    0,    5,   10,   10,    5,    0,  -10,
+             -10,    0,    0,    0,    0,    0,    0,  -10,
+             -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+            // piece-square table: rook, A1 first
+               0,    0,    0,    5,    5,    0,    0,    0,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+              -5,    0,    0,    0,    0,    0,    0,   -5,
+               5,   10,   10,   10,   10,   10,   10,    5,
+               0,    0,    0,    0,    0,    0,    0,    0,
+            // piece-square table: queen, A1 first
+             -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+             -10,    0,    5,    0,    0,    0,    0,  -10,
+             -10,    5,    5,    5,    5,    5,    0,  -10,
+               0,    0,    5,    5,    5,    5,    0,   -5,
+              -5,    0,    5,    5,    5,    5,    0,   -5,
+             -10,    0,    5,    5,    5,    5,    0,  -10,
+             -10,    0,    0,    0,    0,    0,    0,  -10,
+             -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+            // mobility per attacked square by piece type
+               0,    0,    0,    4,    0,    5,    4,    2,
+            // doubled pawn, isolated pawn
+             -20,  -15,
+            // passed pawn by relative rank
+               0,   10,   20,   40,   70,  120,  200,    0,
+            // bishop pair
+              50,
+        };
+    };
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef EVALUATION_HH__
+#define EVALUATION_HH__
+
+#include "Board.hh"
+#include "EvalWeights.hh"
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Tapered static evaluation
+     *
+     * Every term has a middlegame and an endgame weight. The two totals are blended
+     * by the game phase (24 with all pieces on the board, 0 with only pawns and kings).
+     * The weights live in one flat table so they can be adjusted as a unit; the defaults
+     * come from EvalWeights.hh, which the Tuner writes.
+     */
+    class Evaluation{
+        public:
+            // Offsets of each group of terms in the weight table
+            static const int MATERIAL = 0;                  // by Piece type
+            static const int PST = MATERIAL + 8;            // by Piece type * 64 + square from white's side
+            static const int MOBILITY = PST + 8 * 64;       // per attacked square, by Piece type
+            static const int DOUBLED_PAWN = MOBILITY + 8;
+            static const int ISOLATED_PAWN = DOUBLED_PAWN + 1;
+            static const int PASSED_PAWN = ISOLATED_PAWN + 1; // by relative rank
+            static const int BISHOP_PAIR = PASSED_PAWN + 8;
+            static const int TERMS = BISHOP_PAIR + 1;
+
+            static const int MAX_PHASE = 24;
+
+            struct Weights {
+                int mg[TERMS];
+                int eg[TERMS];
+            };
+
+            /**
+             * @brief The weights used by evaluate()
+             */
+            static Weights& weights() {
+                static Weights w = defaultWeights();
+                return w;
+            }
+
+            /**
+             * @brief Game phase from the remaining pieces, MAX_PHASE at the start
+             */
+            static int phase(const Board& board) {
+                int p = 0;
+                for (int color : {Piece::WHITE, Piece::BLACK}) {
+                    p += popCount(board.pieces(color, Piece::KNIGHT)) + popCount(board.pieces(color, Piece::BISHOP))
+                       + 2 * popCount(board.pieces(color, Piece::ROOK)) + 4 * popCount(board.pieces(color, Piece::QUEEN));
+                }
+                return p < MAX_PHASE ? p : MAX_PHASE;
+            }
+
+            /**
+             * @brief Score of the position in centipawns from the side to move's point of view
+             */
+            static int evaluate(const Board& board) {
+                const Weights& w = weights();
+                int mg = 0, eg = 0;
+                for (int color : {Piece::WHITE, Piece::BLACK}) {
+                    int sign = color == Piece::WHITE ? 1 : -1;
+                    int cmg = 0, ceg = 0;
+                    auto add = [&](int term, int count) { cmg += w.mg[term] * count; ceg += w.eg[term] * count; };
+                    evaluateSide(board, color, add);
+                    mg += sign * cmg;
+                    eg += sign * ceg;
+                }
+                int p = phase(board);
+                int score = (mg * p + eg * (MAX_PHASE - p)) / MAX_PHASE;
+                return board.sideToMove() == Piece::WHITE ? score : -score;
+            }
+
+            /**
+             * @brief Feed every term of one side to add(term, count)
+             */
+            template<typename Add>
+            static void evaluateSide(const Board& board, int color, Add&& add) {
+                int them = Piece::Opposite(color);
+                Bitboard occ = board.occupied();
+                Bitboard own = board.pieces(color);
+                Bitboard ownPawns = board.pieces(color, Piece::PAWN);
+                Bitboard enemyPawns = board.pieces(them, Piece::PAWN);
+                int flip = color == Piece::WHITE ? 0 : 56;
+
+                // squares attacked by enemy pawns do not count towards mobility
+                Bitboard enemyPawnAttacks = 0;
+                for (Bitboard b = enemyPawns; b; ) enemyPawnAttacks |= Attacks::pawn(Piece::ColorIndex(them), popLsb(b));
+                Bitboard mobilityArea = ~own & ~enemyPawnAttacks;
+
+                for (int type : {Piece::PAWN, Piece::KNIGHT, Piece::BISHOP, Piece::ROOK, Piece::QUEEN, Piece::KING}) {
+                    Bitboard b = board.pieces(color, type);
+                    if (type != Piece::KING) add(MATERIAL + type, popCount(b));
+                    while (b) {
+                        int sq = popLsb(b);
+                        add(PST + type * 64 + (sq ^ flip), 1);
+                        Bitboard attacks = 0;
+                        switch (type) {
+                            case Piece::KNIGHT: attacks = Attacks::knight(sq); break;
+                            case Piece::BISHOP: attacks = Attacks::bishop(sq, occ); break;
+                            case Piece::ROOK: attacks = Attacks::rook(sq, occ); break;
+                            case Piece::QUEEN: attacks = Attacks::queen(sq, occ); break;
+                            default: break;
+                        }
+                        if (attacks) add(MOBILITY + type, popCount(attacks & mobilityArea));
+                    }
+                }
+
+                for (Bitboard b = ownPawns; b; ) {
+                    int sq = popLsb(b);
+                    int file = sq & 7;
+                    Bitboard fileMask = Attacks::FILE_A << file;
+                    Bitboard adjacent = ((fileMask << 1) & ~Attacks::FILE_A) | ((fileMask >> 1) & ~Attacks::FILE_H);
+                    Bitboard front = color == Piece::WHITE ? Attacks::ray(Attacks::NORTH, sq) : Attacks::ray(Attacks::SOUTH, sq);
+                    int rank = sq >> 3;
+                    Bitboard ahead = color == Piece::WHITE ? ~((1ULL << (8 * rank + 8)) - 1) : (1ULL << (8 * rank)) - 1;
+                    Bitboard frontSpan = front | (adjacent & ahead);
+                    if (ownPawns & front) add(DOUBLED_PAWN, 1);
+                    if (!(ownPawns & adjacent)) add(ISOLATED_PAWN, 1);
+                    if (!(enemyPawns & frontSpan)) add(PASSED_PAWN + ((sq ^ flip) >> 3), 1);
+                }
+
+                if (popCount(board.pieces(color, Piece::BISHOP)) >= 2) add(BISHOP_PAIR, 1);
+            }
+
+        private:
+            static Weights defaultWeights() {
+                static_assert(sizeof(EvalWeights::MG) / sizeof(int) == TERMS, "EvalWeights.hh is out of date, rerun the Tuner");
+                static_assert(sizeof(EvalWeights::EG) / sizeof(int) == TERMS, "EvalWeights.hh is out of date, rerun the Tuner");
+                Weights w;
+                for (int term = 0; term < TERMS; ++term) {
+                    w.mg[term] = EvalWeights::MG[term];
+                    w.eg[term] = EvalWeights::EG[term];
+                }
+                return w;
+            }
+    };
+}
+
+#endif
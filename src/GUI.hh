@@ -8,6 +8,7 @@
 #include <FL/Fl_Menu_Bar.H>
 #include <FL/Fl_Menu_Item.H>
 #include <FL/Fl_Output.H>
+#include <FL/Fl_Slider.H>
 #include "Attributes.hh"
 #include "Point.hh"
 #include "Widget.hh"
@@ -199,6 +200,68 @@ namespace AUGL {
     }
 };
 
+  /**
+   * @class Slider
+   * @authors Kaleb Gebrehiwot and Sofonias Gebre
+   * @brief A horizontal slider over a range of whole numbers.
+   *        The callback is called while the slider is dragged.
+   */
+  class Slider : public Widget {
+  public:
+
+    /**
+     * @brief Construct a slider with an upper left point, a width, a height, and a callback
+     */
+    Slider(const Point& p, int width, int height, Callback_t callback) : Widget(p,width,height,{""},callback), m_minimum(0), m_maximum(0), m_value(0) {}
+
+    /**
+     * @brief Override Widget::attach() to attach the slider to the window
+     */
+    void attach(Window* w){
+      m_owner = w;
+      Fl_Slider *slider = new Fl_Slider(m_point.x,m_point.y,m_width,m_height);
+      slider->type(FL_HOR_NICE_SLIDER);
+      slider->step(1);
+      slider->bounds(m_minimum,m_maximum);
+      slider->value(m_value);
+      slider->callback(reinterpret_cast<Fl_Callback*>(m_callback),m_owner);
+      m_widget = slider;
+    }
+
+    /**
+     * @brief Set the smallest and largest value
+     */
+    void setRange(int minimum, int maximum){
+      m_minimum = minimum;
+      m_maximum = maximum;
+      if(m_widget != nullptr){
+	static_cast<Fl_Slider*>(m_widget)->bounds(minimum,maximum);
+	m_widget->redraw();
+      }
+    }
+
+    /**
+     * @brief Move the slider to a value
+     */
+    void setValue(int value){
+      m_value = value;
+      if(m_widget != nullptr)
+	static_cast<Fl_Slider*>(m_widget)->value(value);
+    }
+
+    /**
+     * @brief return the value the slider is at
+     */
+    int value() const {
+      return m_widget != nullptr ? static_cast<int>(static_cast<Fl_Slider*>(m_widget)->value() + 0.5) : m_value;
+    }
+
+  private:
+    int m_minimum; //!value at the left end
+    int m_maximum; //!value at the right end
+    int m_value; //!value before the slider is attached
+  };
+
   /**
    * @class MenuItem
    * @author ngrau@augie.edu
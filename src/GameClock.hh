@@ -0,0 +1,126 @@
+#ifndef GAMECLOCK_HH__
+#define GAMECLOCK_HH__
+
+#include "Piece.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Chess clock for both players on the monotonic steady clock
+     *
+     * Fischer mode adds the full increment after every move. Bronstein mode gives
+     * back the time the move took, up to the increment, so a player's time never
+     * grows. A clock that runs out stays at zero and is flagged.
+     */
+    class GameClock{
+        public:
+            enum Mode { FISCHER, BRONSTEIN };
+            typedef std::chrono::steady_clock Clock;
+
+            GameClock(int64_t baseMs = 0, int64_t incrementMs = 0, Mode mode = FISCHER) {
+                reset(baseMs, incrementMs, mode);
+            }
+
+            /**
+             * @brief Set both clocks to the base time and stop them
+             */
+            void reset(int64_t baseMs, int64_t incrementMs, Mode mode = FISCHER) {
+                m_remaining[0] = m_remaining[1] = std::chrono::milliseconds(baseMs);
+                m_increment = std::chrono::milliseconds(incrementMs);
+                m_mode = mode;
+                m_running = -1;
+            }
+
+            /**
+             * @brief Continue a saved game: set the time left of each side, both clocks stopped
+             */
+            void restore(int64_t whiteMs, int64_t blackMs, int64_t incrementMs, Mode mode) {
+                reset(0, incrementMs, mode);
+                m_remaining[0] = std::chrono::milliseconds(whiteMs);
+                m_remaining[1] = std::chrono::milliseconds(blackMs);
+            }
+
+            /**
+             * @brief Start the clock of the side to move (Piece::WHITE or Piece::BLACK)
+             */
+            void start(int color) {
+                m_running = Piece::ColorIndex(color);
+                m_turnStart = Clock::now();
+            }
+
+            /**
+             * @brief The running side finished its move: charge the time, add the increment and
+             *        start the opponent's clock. Returns the milliseconds the move took.
+             */
+            int64_t press() {
+                if (m_running < 0) return 0;
+                Clock::duration used = Clock::now() - m_turnStart;
+                int side = m_running;
+                charge(side, used);
+                if (m_remaining[side] > Clock::duration::zero()) {
+                    m_remaining[side] += m_mode == FISCHER ? m_increment : std::min(used, m_increment);
+                }
+                start(side == 0 ? Piece::BLACK : Piece::WHITE);
+                return std::chrono::duration_cast<std::chrono::milliseconds>(used).count();
+            }
+
+            /**
+             * @brief Stop both clocks, charging the running side for its time so far
+             */
+            void stop() {
+                if (m_running < 0) return;
+                charge(m_running, Clock::now() - m_turnStart);
+                m_running = -1;
+            }
+
+            bool running() const { return m_running >= 0; }
+
+            /**
+             * @brief Time left for a side in milliseconds, counting the move in progress
+             */
+            int64_t remainingMs(int color) const {
+                int c = Piece::ColorIndex(color);
+                Clock::duration left = m_remaining[c];
+                if (c == m_running) left -= Clock::now() - m_turnStart;
+                int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(left).count();
+                return ms > 0 ? ms : 0;
+            }
+
+            int64_t incrementMs() const {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(m_increment).count();
+            }
+
+            Mode mode() const { return m_mode; }
+
+            bool flagged(int color) const { return remainingMs(color) <= 0; }
+
+            /**
+             * @brief Time left as "m:ss", or "s.t" under ten seconds
+             */
+            std::string format(int color) const {
+                int64_t ms = remainingMs(color);
+                if (ms < 10000) return std::to_string(ms / 1000) + "." + std::to_string(ms / 100 % 10);
+                int64_t s = ms / 1000;
+                return std::to_string(s / 60) + ":" + (s % 60 < 10 ? "0" : "") + std::to_string(s % 60);
+            }
+
+        private:
+            void charge(int side, Clock::duration used) {
+                m_remaining[side] -= used;
+                if (m_remaining[side] < Clock::duration::zero()) m_remaining[side] = Clock::duration::zero();
+            }
+
+            Clock::duration m_remaining[2]; //!time left of white and black, not counting the running move
+            Clock::duration m_increment; //!added after every move
+            Mode m_mode; //!how the increment is given
+            int m_running; //!color index of the running clock, -1 when stopped
+            Clock::time_point m_turnStart; //!when the running clock was started
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "GameDatabase.hh"
+#include "Notation.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Command line tool for the binary game database
+ *
+ *   GameDatabase import <games.txt> <games.ksg>   one game per line: result then the moves in SAN
+ *                                                 or UCI notation, move numbers ("12.") are skipped
+ *   GameDatabase index <games.ksg> <games.ksi> [threads]
+ *   GameDatabase explore <games.ksi> [fen]
+ */
+int importGames(const std::string& textPath, const std::string& dbPath) {
+    std::ifstream in(textPath);
+    KS::GameWriter writer;
+    if (!in || !writer.open(dbPath)) {
+        std::cerr << "Cannot open " << textPath << " or " << dbPath << std::endl;
+        return 1;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::istringstream words(line);
+        std::string result, text;
+        if (!(words >> result)) continue;
+
+        KS::Board board;
+        std::vector<KS::Move> moves;
+        bool legal = true;
+        while (words >> text) {
+            size_t dot = text.rfind('.');
+            if (dot != std::string::npos) text.erase(0, dot + 1);
+            if (text.empty()) continue;
+            KS::Move m = KS::Notation::parse(board, text);
+            legal = !m.isNull();
+            if (!legal) break;
+            moves.push_back(m);
+            KS::Board::Undo u;
+            board.makeMove(m, u);
+        }
+        if (!legal) {
+            std::cerr << "Skipping line " << lineNumber << ": illegal move " << text << std::endl;
+        } else if (moves.size() > KS::GameDatabase::MAX_PLIES) {
+            std::cerr << "Skipping line " << lineNumber << ": game longer than " << KS::GameDatabase::MAX_PLIES << " plies" << std::endl;
+        } else if (!writer.addGame(moves, KS::GameDatabase::parseResult(result))) {
+            std::cerr << "Cannot write to " << dbPath << std::endl;
+            return 1;
+        }
+    }
+    writer.close();
+    std::cout << writer.games() << " games written to " << dbPath << std::endl;
+    return 0;
+}
+
+int buildIndex(const std::string& dbPath, const std::string& indexPath, unsigned threads) {
+    KS::GameFile games;
+    if (!games.open(dbPath)) {
+        std::cerr << "Cannot read game file " << dbPath << std::endl;
+        return 1;
+    }
+    if (!KS::PositionIndex::build(games, indexPath, threads)) {
+        std::cerr << "Failed to build " << indexPath << std::endl;
+        return 1;
+    }
+    std::cout << "Indexed " << games.games() << " games into " << indexPath << std::endl;
+    return 0;
+}
+
+int explore(const std::string& indexPath, const std::string& fen) {
+    KS::PositionIndex index;
+    if (!index.open(indexPath)) {
+        std::cerr << "Cannot read index " << indexPath << std::endl;
+        return 1;
+    }
+    KS::Board board;
+    if (!board.setFen(fen)) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return 1;
+    }
+    for (const auto& m : index.explore(board)) {
+        std::cout << KS::Notation::san(board, m.move) << "\t" << m.games << " games\t+" << m.whiteWins << " =" << m.draws << " -" << m.blackWins << std::endl;
+    }
+    return 0;
+}
+
+// A positive thread count, or 0 if the text is not one
+unsigned parseThreads(const char* text) {
+    char* end;
+    long n = std::strtol(text, &end, 10);
+    return end != text && *end == '\0' && n > 0 && n <= 1024 ? static_cast<unsigned>(n) : 0;
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "import" && argc == 4) return importGames(argv[2], argv[3]);
+    unsigned threads = argc > 4 ? parseThreads(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+    if (command == "index" && (argc == 4 || argc == 5) && threads) return buildIndex(argv[2], argv[3], threads);
+    if (command == "explore" && argc >= 3) return explore(argv[2], argc > 3 ? argv[3] : KS::Board::START_FEN);
+
+    std::cerr << "Usage: " << argv[0] << " import <games.txt> <games.ksg>\n"
+              << "       " << argv[0] << " index <games.ksg> <games.ksi> [threads]\n"
+              << "       " << argv[0] << " explore <games.ksi> [fen]" << std::endl;
+    return 1;
+}
@@ -0,0 +1,423 @@
+#ifndef GAMEDATABASE_HH__
+#define GAMEDATABASE_HH__
+
+#include "Board.hh"
+#include "MappedFile.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Compact binary storage for games
+     *
+     * A game file (.ksg) is a FileHeader followed by the games back to back. Each game
+     * is a 4 byte GameHeader followed by one byte per ply: the index of the played move
+     * in Board::generateLegalMoves() of the position it was played in. Every game starts
+     * from the standard starting position.
+     */
+    class GameDatabase{
+        public:
+            enum Result { UNKNOWN = 0, WHITE_WINS = 1, BLACK_WINS = 2, DRAW = 3 };
+
+            struct FileHeader {
+                char magic[4]; // "KSGD"
+                uint32_t version;
+                uint64_t games;
+            };
+
+            struct GameHeader {
+                uint16_t plies;
+                uint8_t result;
+                uint8_t reserved;
+            };
+
+            static const uint32_t VERSION = 1;
+            static const size_t MAX_PLIES = 0xFFFF;   // GameHeader::plies is 16 bits
+
+            /**
+             * @brief Encode moves played from the start position as move indices,
+             *        returns false if a move is illegal or the game is too long
+             */
+            static bool encode(const std::vector<Move>& moves, std::string& out) {
+                if (moves.size() > MAX_PLIES) return false;
+                Board board;
+                out.clear();
+                out.reserve(moves.size());
+                for (const Move& m : moves) {
+                    MoveList legal;
+                    board.generateLegalMoves(legal);
+                    int index = static_cast<int>(std::find(legal.begin(), legal.end(), m) - legal.begin());
+                    if (index == legal.size()) return false;
+                    out += static_cast<char>(index);
+                    Board::Undo u;
+                    board.makeMove(m, u);
+                }
+                return true;
+            }
+
+            /**
+             * @brief Decode move indices back into moves, returns false on a corrupt index
+             */
+            static bool decode(const unsigned char* bytes, int plies, std::vector<Move>& moves) {
+                Board board;
+                moves.clear();
+                for (int i = 0; i < plies; ++i) {
+                    MoveList legal;
+                    board.generateLegalMoves(legal);
+                    if (bytes[i] >= legal.size()) return false;
+                    Move m = legal[bytes[i]];
+                    moves.push_back(m);
+                    Board::Undo u;
+                    board.makeMove(m, u);
+                }
+                return true;
+            }
+
+            /**
+             * @brief Result text as used in PGN, e.g. "1-0"
+             */
+            static const char* resultString(int result) {
+                static const char* names[4] = {"*", "1-0", "0-1", "1/2-1/2"};
+                return names[result & 3];
+            }
+
+            static int parseResult(const std::string& text) {
+                if (text == "1-0") return WHITE_WINS;
+                if (text == "0-1") return BLACK_WINS;
+                if (text == "1/2-1/2") return DRAW;
+                return UNKNOWN;
+            }
+    };
+
+    /**
+     * @brief Appends games to a game file
+     */
+    class GameWriter{
+        public:
+            GameWriter() : m_games(0) {}
+
+            ~GameWriter() {
+                close();
+            }
+
+            bool open(const std::string& path) {
+                m_out.open(path, std::ios::binary | std::ios::trunc);
+                m_games = 0;
+                writeHeader();
+                return m_out.good();
+            }
+
+            /**
+             * @brief Append a game, returns false if it cannot be encoded
+             */
+            bool addGame(const std::vector<Move>& moves, int result) {
+                if (!GameDatabase::encode(moves, m_buffer)) return false;
+                GameDatabase::GameHeader header = {static_cast<uint16_t>(m_buffer.size()), static_cast<uint8_t>(result), 0};
+                m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                ++m_games;
+                return m_out.good();
+            }
+
+            uint64_t games() const { return m_games; }
+
+            /**
+             * @brief Write the final game count and close the file
+             */
+            void close() {
+                if (!m_out.is_open()) return;
+                m_out.seekp(0);
+                writeHeader();
+                m_out.close();
+            }
+
+        private:
+            void writeHeader() {
+                GameDatabase::FileHeader header = {{'K', 'S', 'G', 'D'}, GameDatabase::VERSION, m_games};
+                m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            }
+
+            std::ofstream m_out; //!the game file being written
+            uint64_t m_games; //!number of games written so far
+            std::string m_buffer; //!encoding scratch space reused between games
+    };
+
+    /**
+     * @brief Read access to a memory-mapped game file
+     */
+    class GameFile{
+        public:
+            /**
+             * @brief Map the file and find where each game starts
+             */
+            bool open(const std::string& path) {
+                m_offsets.clear();
+                if (!m_file.open(path) || m_file.size() < sizeof(GameDatabase::FileHeader)) return false;
+                GameDatabase::FileHeader header;
+                std::memcpy(&header, m_file.data(), sizeof(header));
+                if (std::memcmp(header.magic, "KSGD", 4) != 0 || header.version != GameDatabase::VERSION) return false;
+
+                // every game takes at least its header, so a larger count is a corrupt file
+                if (header.games > (m_file.size() - sizeof(header)) / sizeof(GameDatabase::GameHeader)) return false;
+                m_offsets.reserve(header.games);
+                size_t offset = sizeof(header);
+                for (uint64_t i = 0; i < header.games; ++i) {
+                    if (offset + sizeof(GameDatabase::GameHeader) > m_file.size()) return false;
+                    m_offsets.push_back(offset);
+                    offset += sizeof(GameDatabase::GameHeader) + gameHeader(i).plies;
+                }
+                return offset <= m_file.size();
+            }
+
+            size_t games() const { return m_offsets.size(); }
+
+            GameDatabase::GameHeader gameHeader(size_t id) const {
+                GameDatabase::GameHeader header;
+                std::memcpy(&header, m_file.data() + m_offsets[id], sizeof(header));
+                return header;
+            }
+
+            /** @brief The encoded move indices of a game */
+            const unsigned char* moveBytes(size_t id) const {
+                return m_file.data() + m_offsets[id] + sizeof(GameDatabase::GameHeader);
+            }
+
+            bool game(size_t id, std::vector<Move>& moves, int& result) const {
+                GameDatabase::GameHeader header = gameHeader(id);
+                result = header.result;
+                return GameDatabase::decode(moveBytes(id), header.plies, moves);
+            }
+
+        private:
+            MappedFile m_file; //!the mapped game file
+            std::vector<size_t> m_offsets; //!byte offset of every game
+    };
+
+    /**
+     * @brief A sorted index from position keys to the games they occur in
+     *
+     * The index file (.ksi) is a header followed by IndexEntry records sorted by
+     * key, game and ply, so all occurrences of a position are one contiguous range
+     * found by binary search in the memory-mapped file.
+     */
+    class PositionIndex{
+        public:
+            struct Header {
+                char magic[4]; // "KSPI"
+                uint32_t version;
+                uint64_t entries;
+            };
+
+            struct IndexEntry {
+                uint64_t key; // Zobrist key of the position
+                uint32_t game; // game id in the game file
+                uint16_t ply; // ply the position occurred at
+                uint8_t move; // index of the move played from here, NO_MOVE at the end of a game
+                uint8_t result; // the game's GameDatabase::Result
+
+                bool operator<(const IndexEntry& o) const {
+                    if (key != o.key) return key < o.key;
+                    if (game != o.game) return game < o.game;
+                    return ply < o.ply;
+                }
+            };
+
+            struct ExplorerMove {
+                Move move;
+                uint32_t games;
+                uint32_t whiteWins;
+                uint32_t draws;
+                uint32_t blackWins;
+            };
+
+            static const uint8_t NO_MOVE = 0xFF;
+
+            /**
+             * @brief Build an index over every position of every game with an external sort
+             *
+             * Each thread decodes its share of the games and writes sorted runs of at most
+             * runEntries entries to temporary files, which are then merged into the index.
+             */
+            static bool build(const GameFile& games, const std::string& path, unsigned threads = std::thread::hardware_concurrency(), size_t runEntries = 1 << 22) {
+                if (threads == 0) threads = 1;
+                std::atomic<size_t> nextGame(0);
+                std::atomic<int> nextRun(0);
+                std::atomic<bool> failed(false);
+
+                auto writeRun = [&](std::vector<IndexEntry>& run) {
+                    std::sort(run.begin(), run.end());
+                    std::ofstream out(runPath(path, nextRun++), std::ios::binary | std::ios::trunc);
+                    out.write(reinterpret_cast<const char*>(run.data()), static_cast<std::streamsize>(run.size() * sizeof(IndexEntry)));
+                    if (!out.good()) failed = true;
+                    run.clear();
+                };
+
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([&]() {
+                        std::vector<IndexEntry> run;
+                        run.reserve(runEntries);
+                        for (size_t id = nextGame++; id < games.games(); id = nextGame++) {
+                            GameDatabase::GameHeader header = games.gameHeader(id);
+                            const unsigned char* bytes = games.moveBytes(id);
+                            Board board;
+                            for (int ply = 0; ply <= header.plies; ++ply) {
+                                uint8_t index = ply < header.plies ? bytes[ply] : NO_MOVE;
+                                run.push_back({board.zobrist(), static_cast<uint32_t>(id), static_cast<uint16_t>(ply), index, header.result});
+                                if (run.size() == runEntries) writeRun(run);
+                                if (index == NO_MOVE) break;
+                                MoveList legal;
+                                board.generateLegalMoves(legal);
+                                if (index >= legal.size()) { failed = true; break; }
+                                Board::Undo u;
+                                board.makeMove(legal[index], u);
+                            }
+                        }
+                        if (!run.empty()) writeRun(run);
+                    });
+                }
+                for (auto& w : workers) w.join();
+
+                bool ok = !failed && merge(path, nextRun);
+                for (int r = 0; r < nextRun; ++r) std::remove(runPath(path, r).c_str());
+                return ok;
+            }
+
+            /**
+             * @brief Map an index file for lookups
+             */
+            bool open(const std::string& path) {
+                m_entries = nullptr;
+                m_count = 0;
+                if (!m_file.open(path) || m_file.size() < sizeof(Header)) return false;
+                Header header;
+                std::memcpy(&header, m_file.data(), sizeof(header));
+                if (std::memcmp(header.magic, "KSPI", 4) != 0 || header.version != GameDatabase::VERSION) return false;
+                if (sizeof(Header) + header.entries * sizeof(IndexEntry) > m_file.size()) return false;
+                m_entries = reinterpret_cast<const IndexEntry*>(m_file.data() + sizeof(Header));
+                m_count = header.entries;
+                return true;
+            }
+
+            uint64_t entries() const { return m_count; }
+
+            /**
+             * @brief All occurrences of a position as a [first, last) range of entries
+             */
+            std::pair<const IndexEntry*, const IndexEntry*> find(uint64_t key) const {
+                const IndexEntry* end = m_entries + m_count;
+                const IndexEntry* first = std::lower_bound(m_entries, end, key, [](const IndexEntry& e, uint64_t k) { return e.key < k; });
+                const IndexEntry* last = first;
+                while (last != end && last->key == key) ++last;
+                return {first, last};
+            }
+
+            /**
+             * @brief Ids of the games a position occurred in, ascending
+             */
+            std::vector<uint32_t> gamesWith(const Board& board) const {
+                std::vector<uint32_t> ids;
+                auto range = find(board.zobrist());
+                for (const IndexEntry* e = range.first; e != range.second; ++e) {
+                    if (ids.empty() || ids.back() != e->game) ids.push_back(e->game);
+                }
+                return ids;
+            }
+
+            /**
+             * @brief Opening explorer: how often each move was played from a position and how
+             *        those games ended, most played first
+             */
+            std::vector<ExplorerMove> explore(Board board) const {
+                ExplorerMove stats[256] = {};
+                auto range = find(board.zobrist());
+                for (const IndexEntry* e = range.first; e != range.second; ++e) {
+                    if (e->move == NO_MOVE) continue;
+                    ExplorerMove& s = stats[e->move];
+                    ++s.games;
+                    if (e->result == GameDatabase::WHITE_WINS) ++s.whiteWins;
+                    else if (e->result == GameDatabase::BLACK_WINS) ++s.blackWins;
+                    else if (e->result == GameDatabase::DRAW) ++s.draws;
+                }
+
+                MoveList legal;
+                board.generateLegalMoves(legal);
+                std::vector<ExplorerMove> moves;
+                for (int i = 0; i < legal.size(); ++i) {
+                    if (stats[i].games == 0) continue;
+                    stats[i].move = legal[i];
+                    moves.push_back(stats[i]);
+                }
+                std::stable_sort(moves.begin(), moves.end(), [](const ExplorerMove& a, const ExplorerMove& b) { return a.games > b.games; });
+                return moves;
+            }
+
+        private:
+            static std::string runPath(const std::string& path, int run) {
+                return path + ".run" + std::to_string(run);
+            }
+
+            // k-way merge of the sorted runs into the final index file
+            static bool merge(const std::string& path, int runs) {
+                struct Cursor {
+                    std::ifstream in;
+                    std::vector<IndexEntry> buffer;
+                    size_t pos = 0;
+
+                    bool refill() {
+                        buffer.resize(1 << 14);
+                        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(IndexEntry)));
+                        buffer.resize(static_cast<size_t>(in.gcount()) / sizeof(IndexEntry));
+                        pos = 0;
+                        return !buffer.empty();
+                    }
+                };
+
+                std::vector<Cursor> cursors(runs);
+                auto later = [&](int a, int b) { return cursors[b].buffer[cursors[b].pos] < cursors[a].buffer[cursors[a].pos]; };
+                std::priority_queue<int, std::vector<int>, decltype(later)> heap(later);
+                for (int r = 0; r < runs; ++r) {
+                    cursors[r].in.open(runPath(path, r), std::ios::binary);
+                    if (cursors[r].refill()) heap.push(r);
+                }
+
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                Header header = {{'K', 'S', 'P', 'I'}, GameDatabase::VERSION, 0};
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+                std::vector<IndexEntry> pending;
+                pending.reserve(1 << 14);
+                while (!heap.empty()) {
+                    int r = heap.top();
+                    heap.pop();
+                    pending.push_back(cursors[r].buffer[cursors[r].pos++]);
+                    ++header.entries;
+                    if (pending.size() == pending.capacity()) {
+                        out.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(pending.size() * sizeof(IndexEntry)));
+                        pending.clear();
+                    }
+                    if (cursors[r].pos < cursors[r].buffer.size() || cursors[r].refill()) heap.push(r);
+                }
+                out.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(pending.size() * sizeof(IndexEntry)));
+                out.seekp(0);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                return out.good();
+            }
+
+            MappedFile m_file; //!the mapped index file
+            const IndexEntry* m_entries = nullptr; //!the sorted entries inside the mapping
+            uint64_t m_count = 0; //!number of entries
+    };
+}
+
+#endif
@@ -2,7 +2,12 @@
 #include <FL/Fl_Button.H>
 #include <FL/Fl_Box.H>
 #include <FL/Fl.H>
+#include <functional>
+#include <iostream>
 #include <string>
+#include "Board.hh"
+#include "Notation.hh"
+#include "Replay.hh"
 
 class GameOverWindow : public Fl_Window {
 public:
@@ -11,30 +16,62 @@ public:
 
         winner_box = new Fl_Box(100, 50, 300, 50, "Winner: ");
         move_summary_box = new Fl_Box(100, 120, 300, 100, "Move Summary: ");
+        move_summary_box->align(FL_ALIGN_INSIDE | FL_ALIGN_WRAP | FL_ALIGN_TOP_LEFT);
         replay_button = new Fl_Button(100, 250, 100, 30, "Replay");
         quit_button = new Fl_Button(250, 250, 100, 30, "Quit");
 
         replay_button->callback([](Fl_Widget*, void* window) {
-            // Implement Replay logic here
-            static_cast<Fl_Window*>(window)->hide();
-        });
+            GameOverWindow* self = static_cast<GameOverWindow*>(window);
+            if (self->on_replay_) self->on_replay_(0);  // the owner replays the game from its first position
+            self->hide();
+        }, this);
 
         quit_button->callback([](Fl_Widget*, void* window) {
             static_cast<Fl_Window*>(window)->hide();
-        });
+        }, this);
 
         end();
     }
 
     void set_winner(const std::string& winner) {
-        // Convert the string to const char* and set it as label
-        winner_box->label(("Winner: " + winner).c_str());
+        // the box keeps its own copy, the temporary string is gone after this line
+        winner_box->copy_label(("Winner: " + winner).c_str());
         winner_box->redraw();  // Redraw the box to update the text
     }
 
+    // Set the winner line from the final position, the same rules the engine plays by
+    void set_result(KS::Board& board) {
+        switch (board.gameState()) {
+            case KS::Board::CHECKMATE:
+                set_winner(board.sideToMove() == KS::Piece::WHITE ? "Black (checkmate)" : "White (checkmate)");
+                break;
+            case KS::Board::STALEMATE: set_winner("Draw (stalemate)"); break;
+            case KS::Board::REPETITION: set_winner("Draw (threefold repetition)"); break;
+            case KS::Board::FIFTY_MOVES: set_winner("Draw (fifty-move rule)"); break;
+            case KS::Board::INSUFFICIENT_MATERIAL: set_winner("Draw (insufficient material)"); break;
+            case KS::Board::ONGOING: set_winner("None, the game is not over"); break;
+        }
+    }
+
+    // Show the result and the moves of a finished game
+    void set_game(KS::Replay& game) {
+        KS::Board board = game.start();
+        std::string summary;
+        for (int ply = 0; ply < game.plies(); ++ply) {
+            if (ply % 2 == 0) summary += std::to_string(ply / 2 + 1) + ". ";
+            summary += KS::Notation::san(board, game.move(ply)) + " ";
+            KS::Board::Undo u;
+            board.makeMove(game.move(ply), u);
+        }
+        set_result(board);
+        set_move_summary(summary);
+    }
+
+    // Called with the ply to start from when Replay is pressed
+    void on_replay(std::function<void(int)> handler) { on_replay_ = handler; }
+
     void set_move_summary(const std::string& summary) {
-        // Convert the string to const char* and set it as label
-        move_summary_box->label(("Move Summary: " + summary).c_str());
+        move_summary_box->copy_label(("Move Summary: " + summary).c_str());
         move_summary_box->redraw();  // Redraw the box to update the text
     }
 
@@ -43,12 +80,17 @@ private:
     Fl_Box* move_summary_box;
     Fl_Button* replay_button;
     Fl_Button* quit_button;
+    std::function<void(int)> on_replay_;
 };
 
 int main() {
     GameOverWindow window(500, 350, "Game Over");
-    window.set_winner("");
-    window.set_move_summary("");
+    KS::Replay game;
+    for (const char* move : {"f3", "e5", "g4", "Qh4"}) game.push(KS::Notation::parse(game.seek(game.plies()), move));
+    window.set_game(game);
+    window.on_replay([&game](int ply) {
+        std::cout << "Replay from ply " << ply << ": " << game.seek(ply).fen() << "\n";
+    });
     window.show();
     return Fl::run();
 }
@@ -0,0 +1,715 @@
+#ifndef GAMESERVER_HH__
+#define GAMESERVER_HH__
+
+#include "Board.hh"
+#include "GameClock.hh"
+#include "Notation.hh"
+#include "RingBuffer.hh"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief One game hosted by the server: the position, the clocks and how it ended
+     *
+     * The server is the authority: it checks every move and keeps the time. A base
+     * time of 0 means an untimed game.
+     */
+    struct GameSession {
+        enum State { ONGOING, CHECKMATE, STALEMATE, REPETITION, FIFTY_MOVES, INSUFFICIENT_MATERIAL, TIME, RESIGNED };
+
+        Board board;
+        GameClock clock;
+        bool timed = false;
+        int plies = 0;
+        State state = ONGOING;
+
+        GameSession(int64_t baseMs = 0, int64_t incrementMs = 0) : clock(baseMs, incrementMs), timed(baseMs > 0) {
+            if (timed) clock.start(Piece::WHITE);
+        }
+
+        static const char* stateName(State state) {
+            static const char* const names[] = {"ongoing", "checkmate", "stalemate", "repetition", "fifty", "material", "time", "resigned"};
+            return names[state];
+        }
+
+        /**
+         * @brief Play a move in SAN or UCI notation for the side to move; the reply line is
+         *        appended to out. Returns false if the move was refused.
+         */
+        bool play(uint64_t id, const std::string& text, std::string& out) {
+            if (state != ONGOING) return refuse(id, "over", out);
+            if (timed && clock.flagged(board.sideToMove())) {
+                state = TIME;
+                clock.stop();
+                return refuse(id, "time", out);
+            }
+            Move move = Notation::parse(board, text);
+            if (move.isNull()) return refuse(id, "illegal", out);
+            std::string san = Notation::san(board, move);
+            Board::Undo u;
+            board.makeMove(move, u);
+            ++plies;
+            if (timed) clock.press();
+            Board::GameState result = board.gameState();
+            if (result != Board::ONGOING) {
+                state = static_cast<State>(result);
+                clock.stop();
+            }
+            out += "ok " + std::to_string(id) + " " + std::to_string(plies) + " " + san + " " + times() + " " + stateName(state) + "\n";
+            return true;
+        }
+
+        /**
+         * @brief Appends "pos <id> <whiteMs> <blackMs> <state> <fen>"
+         */
+        void show(uint64_t id, std::string& out) {
+            if (state == ONGOING && timed && clock.flagged(board.sideToMove())) {
+                state = TIME;
+                clock.stop();
+            }
+            out += "pos " + std::to_string(id) + " " + times() + " " + stateName(state) + " " + board.fen() + "\n";
+        }
+
+        /**
+         * @brief The side to move gives up; appends "over <id> <state>"
+         */
+        void resign(uint64_t id, std::string& out) {
+            if (state == ONGOING) state = RESIGNED;
+            clock.stop();
+            out += "over " + std::to_string(id) + " " + stateName(state) + "\n";
+        }
+
+        std::string times() const {
+            if (!timed) return "- -";
+            return std::to_string(clock.remainingMs(Piece::WHITE)) + " " + std::to_string(clock.remainingMs(Piece::BLACK));
+        }
+
+        static bool refuse(uint64_t id, const char* reason, std::string& out) {
+            out += "err " + std::to_string(id) + " " + reason + "\n";
+            return false;
+        }
+    };
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Headless server hosting many concurrent games over TCP or a Unix socket
+     *
+     * Two kinds of threads share the work. I/O threads each run an epoll event loop;
+     * all loops wait on the same listening socket with EPOLLEXCLUSIVE, so the kernel
+     * hands each new connection to one loop, which then owns it. Game workers own the
+     * games: a game lives on one worker for its whole life and only that worker ever
+     * touches its board and clock.
+     *
+     * They talk through bounded lock-free rings, with no lock anywhere on the move
+     * path. Every game has its own mailbox, an MpscRing any I/O thread can post a
+     * command to; posting to an idle mailbox also puts the game on its worker's run
+     * queue. A worker takes games off its run queue, empties their mailboxes and sends
+     * each reply back through the SpscRing it has with the command's I/O thread. New
+     * games are asked of a worker through its own control ring. A sleeping thread is
+     * woken through an eventfd, and only when it is actually asleep.
+     *
+     * Replies to the commands of one connection may come back from several workers out
+     * of order, so the connection numbers its commands and writes the replies in that
+     * order. A full mailbox refuses the command with "busy" rather than wait.
+     *
+     * The protocol is one line per command and one line per reply, replies in order:
+     *
+     *   new [baseMs incMs]     game <id>
+     *   move <id> <move>       ok <id> <ply> <san> <whiteMs> <blackMs> <state>   (SAN or UCI move)
+     *                          err <id> unknown|over|time|illegal|busy
+     *   show <id>              pos <id> <whiteMs> <blackMs> <state> <fen>
+     *   resign <id>            over <id> resigned
+     *   close <id>             closed <id>
+     *
+     * Times are "-" for untimed games. A state is one of ongoing, checkmate, stalemate,
+     * repetition, fifty, material, time, resigned. A player whose time ran out loses on
+     * the next command for the game. Unknown commands, and a new whose times are not
+     * whole numbers from 0 to a week, get "err 0 command"; a new game that cannot be
+     * made gets "err 0 busy" or "err 0 full", and a line longer than MAX_LINE, finished
+     * or not, closes the connection. A client that shuts down its side still gets the
+     * replies to every complete line it sent before the connection is closed.
+     */
+    class GameServer{
+        public:
+            static const size_t MAX_LINE = 256;
+            static const int MAX_EVENTS = 64;
+            static const uint32_t MAX_GAMES = 1 << 16;    // open games per worker
+            static const uint32_t CHUNK = 256;            // game slots allocated together
+            static const size_t MAILBOX = 32;             // commands waiting per game
+            static const size_t REPLIES = 512;            // replies waiting per worker and I/O thread
+
+            /**
+             * @brief ioThreads event loops and workers game threads, 0 for half the cores each
+             */
+            explicit GameServer(unsigned ioThreads = 0, unsigned workers = 0)
+                : m_listen(-1), m_wake(eventfd(0, EFD_NONBLOCK)), m_stopping(false), m_connections(0), m_commands(0), m_games(0) {
+                unsigned cores = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+                if (!ioThreads) ioThreads = std::max(1u, cores / 2);
+                if (!workers) workers = std::max(1u, cores - cores / 2);
+                for (unsigned i = 0; i < ioThreads; ++i) m_loops.emplace_back(new Loop(workers));
+                for (unsigned i = 0; i < workers; ++i) m_workers.emplace_back(new Worker());
+            }
+
+            ~GameServer() {
+                if (m_listen >= 0) ::close(m_listen);
+                if (m_wake >= 0) ::close(m_wake);
+            }
+
+            GameServer(const GameServer&) = delete;
+            GameServer& operator=(const GameServer&) = delete;
+
+            /**
+             * @brief Listen on a TCP port of the loopback or all interfaces
+             */
+            bool listenTcp(int port, bool loopbackOnly = true) {
+                int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+                if (fd < 0) return false;
+                int one = 1;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                sockaddr_in addr = {};
+                addr.sin_family = AF_INET;
+                addr.sin_port = htons(static_cast<uint16_t>(port));
+                addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+                return listenOn(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), true);
+            }
+
+            /**
+             * @brief Listen on a Unix socket, replacing a stale socket file
+             */
+            bool listenUnix(const std::string& path) {
+                int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+                sockaddr_un addr = {};
+                if (fd < 0 || path.size() >= sizeof(addr.sun_path)) return false;
+                addr.sun_family = AF_UNIX;
+                std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+                ::unlink(path.c_str());
+                return listenOn(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), false);
+            }
+
+            /**
+             * @brief Serve until stop() is called
+             */
+            void run() {
+                std::vector<std::thread> threads;
+                for (unsigned w = 0; w < workers(); ++w) threads.emplace_back([this, w]() { work(w); });
+                for (unsigned i = 1; i < ioThreads(); ++i) threads.emplace_back([this, i]() { loop(i); });
+                loop(0);
+                m_stopping = true;
+                for (auto& w : m_workers) wake(*w);
+                for (std::thread& t : threads) t.join();
+            }
+
+            /**
+             * @brief Make run() return; safe to call from a signal handler
+             */
+            void stop() {
+                uint64_t one = 1;
+                ssize_t written = ::write(m_wake, &one, sizeof(one));
+                (void)written;
+            }
+
+            unsigned ioThreads() const { return static_cast<unsigned>(m_loops.size()); }
+            unsigned workers() const { return static_cast<unsigned>(m_workers.size()); }
+            uint64_t games() const { return m_games; }
+            uint64_t connections() const { return m_connections; }
+            uint64_t commands() const { return m_commands; }
+
+        private:
+            enum Verb : uint8_t { NEW, MOVE, SHOW, RESIGN, CLOSE };
+
+            /**
+             * @brief A command on its way from an I/O thread to a worker
+             */
+            struct Command {
+                uint64_t id;            // game, 0 for new
+                uint64_t token;         // connection on the I/O thread
+                uint64_t seq;           // number of the command on its connection
+                int64_t baseMs, incMs;  // for new
+                uint16_t loop;          // I/O thread to reply to
+                Verb verb;
+                char move[21];          // for move, nul-terminated
+            };
+
+            /**
+             * @brief A reply line on its way back from a worker to an I/O thread
+             */
+            struct Reply {
+                uint64_t token;
+                uint64_t seq;
+                uint16_t length;
+                char text[230];
+            };
+
+            /**
+             * @brief A place for one game: its mailbox and, while it is open, the game.
+             *        Slots are reused; the generation in a game's id tells their games apart.
+             */
+            struct Slot {
+                MpscRing<Command, MAILBOX> mailbox;
+                std::atomic<bool> scheduled{false};  // on the worker's run queue
+                uint64_t id = 0;                     // id of the open game, or of the next one
+                bool open = false;
+                GameSession session;
+            };
+
+            /**
+             * @brief A game thread and the games it owns
+             */
+            struct Worker {
+                MpscRing<Command, 1024> control;             // new games
+                MpscRing<uint32_t, MAX_GAMES> runQueue;      // slots with mail, each at most once
+                std::atomic<Slot*> chunks[MAX_GAMES / CHUNK] = {};
+                std::atomic<bool> sleeping{false};
+                int event = eventfd(0, 0);                   // blocking wake-up
+                // the rest is the worker's own
+                uint32_t allocated = 0;                      // slots made so far
+                std::vector<uint32_t> free;                  // closed slots to reuse
+                std::vector<std::unique_ptr<Slot[]>> memory;
+
+                ~Worker() { ::close(event); }
+            };
+
+            /**
+             * @brief An I/O thread: its event loop and the replies sent to it
+             */
+            struct Loop {
+                int epoll = epoll_create1(0);
+                int event = eventfd(0, EFD_NONBLOCK);        // replies are waiting
+                std::atomic<bool> notified{false};           // event was written and not yet read
+                std::vector<std::unique_ptr<SpscRing<Reply, REPLIES>>> replies;  // one per worker
+
+                explicit Loop(unsigned workers) {
+                    for (unsigned w = 0; w < workers; ++w) replies.emplace_back(new SpscRing<Reply, REPLIES>());
+                }
+                ~Loop() {
+                    ::close(epoll);
+                    ::close(event);
+                }
+            };
+
+            /**
+             * @brief A client connection, owned by the loop that accepted it
+             */
+            struct Connection {
+                int fd = -1;
+                std::string in;     // received bytes not yet ending in a newline
+                std::string out;    // replies not yet sent
+                uint32_t events = EPOLLIN | EPOLLRDHUP;  // what epoll waits for
+                bool ended = false;    // the client sent everything it will send
+                uint64_t nextSeq = 0;  // number of the next command
+                uint64_t flushed = 0;  // number of the next reply to go to out
+                std::unordered_map<uint64_t, std::string> early;  // replies that overtook an earlier one
+            };
+
+            // epoll tokens below FIRST_CONNECTION are the loop's own descriptors
+            static const uint64_t LISTEN = 0, STOP = 1, REPLY = 2, FIRST_CONNECTION = 3;
+
+            bool listenOn(int fd, sockaddr* addr, socklen_t size, bool tcp) {
+                if (bind(fd, addr, size) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+                    ::close(fd);
+                    return false;
+                }
+                if (m_listen >= 0) ::close(m_listen);
+                m_listen = fd;
+                m_tcp = tcp;
+                return true;
+            }
+
+            // Game ids: the low 32 bits number the slot across workers, the high bits are its generation
+            uint64_t gameId(unsigned worker, uint32_t index, uint64_t generation) const {
+                return generation << 32 | (static_cast<uint64_t>(index) * workers() + worker + 1);
+            }
+
+            // The slot a game id points to, null if it was never made
+            Slot* slot(uint64_t id, unsigned& worker, uint32_t& index) const {
+                uint32_t n = static_cast<uint32_t>(id);
+                if (n == 0) return nullptr;
+                worker = (n - 1) % workers();
+                uint64_t i = (n - 1) / workers();
+                if (i >= MAX_GAMES) return nullptr;
+                index = static_cast<uint32_t>(i);
+                Slot* chunk = m_workers[worker]->chunks[index / CHUNK].load(std::memory_order_acquire);
+                return chunk ? &chunk[index % CHUNK] : nullptr;
+            }
+
+            static void wake(Worker& w) {
+                uint64_t one = 1;
+                ssize_t written = ::write(w.event, &one, sizeof(one));
+                (void)written;
+            }
+
+            // Wake a worker that went to sleep, after giving it work
+            static void nudge(Worker& w) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (w.sleeping.load(std::memory_order_relaxed) && w.sleeping.exchange(false)) wake(w);
+            }
+
+            // ---- I/O threads ----
+
+            void loop(unsigned self) {
+                Loop& l = *m_loops[self];
+                epoll_event ev = {};
+                ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+                ev.data.u64 = LISTEN;
+                epoll_ctl(l.epoll, EPOLL_CTL_ADD, m_listen, &ev);
+                ev.events = EPOLLIN;
+                ev.data.u64 = STOP;
+                epoll_ctl(l.epoll, EPOLL_CTL_ADD, m_wake, &ev);
+                ev.data.u64 = REPLY;
+                epoll_ctl(l.epoll, EPOLL_CTL_ADD, l.event, &ev);
+
+                std::unordered_map<uint64_t, Connection> connections;
+                uint64_t nextToken = FIRST_CONNECTION;
+                unsigned nextWorker = self;
+                epoll_event events[MAX_EVENTS];
+                for (bool running = true; running;) {
+                    int n = epoll_wait(l.epoll, events, MAX_EVENTS, -1);
+                    if (n < 0 && errno != EINTR) break;
+                    for (int i = 0; i < n; ++i) {
+                        uint64_t token = events[i].data.u64;
+                        if (token == STOP) running = false;
+                        else if (token == LISTEN) accept(l, connections, nextToken);
+                        else if (token == REPLY) collect(l, connections);
+                        else {
+                            auto it = connections.find(token);
+                            if (it == connections.end()) continue;
+                            Connection& c = it->second;
+                            bool open = !(events[i].events & (EPOLLERR | EPOLLHUP));
+                            if (open && (events[i].events & EPOLLIN)) open = receive(self, token, c, nextWorker);
+                            if (open) open = send(l, token, c);
+                            if (!open) {
+                                ::close(c.fd);  // also removes it from the epoll set
+                                connections.erase(it);
+                            }
+                        }
+                    }
+                }
+                for (auto& c : connections) ::close(c.second.fd);
+            }
+
+            void accept(Loop& l, std::unordered_map<uint64_t, Connection>& connections, uint64_t& nextToken) {
+                for (;;) {
+                    int fd = accept4(m_listen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0) return;  // EAGAIN: another loop took it, or none left
+                    if (m_tcp) {
+                        int one = 1;
+                        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    }
+                    epoll_event ev = {};
+                    ev.events = EPOLLIN | EPOLLRDHUP;
+                    ev.data.u64 = nextToken;
+                    if (epoll_ctl(l.epoll, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                        ::close(fd);
+                        continue;
+                    }
+                    connections[nextToken++].fd = fd;
+                    m_connections.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // Read what is there and pass on every complete line, false when the connection must close
+            bool receive(unsigned self, uint64_t token, Connection& c, unsigned& nextWorker) {
+                char buffer[4096];
+                while (!c.ended) {
+                    ssize_t got = ::recv(c.fd, buffer, sizeof(buffer), 0);
+                    if (got == 0) {
+                        c.ended = true;  // the lines read so far are still answered
+                        break;
+                    }
+                    if (got < 0) {
+                        if (errno == EINTR) continue;
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                        return false;
+                    }
+                    c.in.append(buffer, static_cast<size_t>(got));
+                }
+                size_t start = 0;
+                uint64_t lines = 0;
+                for (size_t end; (end = c.in.find('\n', start)) != std::string::npos; start = end + 1, ++lines) {
+                    size_t length = end - start;
+                    if (length && c.in[end - 1] == '\r') --length;
+                    if (length > MAX_LINE) return false;
+                    command(self, token, c, c.in.data() + start, length, nextWorker);
+                }
+                c.in.erase(0, start);
+                m_commands.fetch_add(lines, std::memory_order_relaxed);
+                if (c.ended) c.in.clear();  // an unfinished last line is never answered
+                return c.in.size() <= MAX_LINE;
+            }
+
+            // Send what is queued; wait for EPOLLOUT only while something is left and stop
+            // reading once the client has ended. False when the connection must close: on an
+            // error, or when an ended client has every reply it is owed.
+            bool send(Loop& l, uint64_t token, Connection& c) {
+                size_t sent = 0;
+                while (sent < c.out.size()) {
+                    ssize_t n = ::send(c.fd, c.out.data() + sent, c.out.size() - sent, MSG_NOSIGNAL);
+                    if (n < 0) {
+                        if (errno == EINTR) continue;
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                        return false;
+                    }
+                    sent += static_cast<size_t>(n);
+                }
+                c.out.erase(0, sent);
+                if (c.ended && c.out.empty() && c.flushed == c.nextSeq) return false;
+                uint32_t events = c.ended ? 0 : EPOLLIN | EPOLLRDHUP;
+                if (!c.out.empty()) events |= EPOLLOUT;
+                if (events != c.events) {
+                    epoll_event ev = {};
+                    ev.events = events;
+                    ev.data.u64 = token;
+                    epoll_ctl(l.epoll, EPOLL_CTL_MOD, c.fd, &ev);
+                    c.events = events;
+                }
+                return true;
+            }
+
+            // Queue the reply to command seq behind the replies to the commands before it
+            static void deliver(Connection& c, uint64_t seq, const char* text, size_t length) {
+                if (seq != c.flushed) {
+                    c.early.emplace(seq, std::string(text, length));
+                    return;
+                }
+                c.out.append(text, length);
+                ++c.flushed;
+                for (auto it = c.early.find(c.flushed); it != c.early.end(); it = c.early.find(c.flushed)) {
+                    c.out += it->second;
+                    c.early.erase(it);
+                    ++c.flushed;
+                }
+            }
+
+            // Take the replies the workers sent and write them out
+            void collect(Loop& l, std::unordered_map<uint64_t, Connection>& connections) {
+                uint64_t count;
+                ssize_t got = ::read(l.event, &count, sizeof(count));
+                (void)got;
+                l.notified.exchange(false, std::memory_order_acq_rel);
+                std::vector<uint64_t> touched;
+                Reply r;
+                for (auto& ring : l.replies) {
+                    while (ring->pop(r)) {
+                        auto it = connections.find(r.token);
+                        if (it == connections.end()) continue;  // closed meanwhile
+                        deliver(it->second, r.seq, r.text, r.length);
+                        touched.push_back(r.token);
+                    }
+                }
+                std::sort(touched.begin(), touched.end());
+                touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+                for (uint64_t token : touched) {
+                    auto it = connections.find(token);
+                    if (!send(l, token, it->second)) {
+                        ::close(it->second.fd);
+                        connections.erase(it);
+                    }
+                }
+            }
+
+            // Split a line into at most four words
+            static int words(const char* line, size_t length, std::string word[4]) {
+                int count = 0;
+                for (size_t i = 0; i < length && count < 4;) {
+                    while (i < length && line[i] == ' ') ++i;
+                    size_t start = i;
+                    while (i < length && line[i] != ' ') ++i;
+                    if (i > start) word[count++].assign(line + start, i - start);
+                }
+                return count;
+            }
+
+            // A time in a new command: a whole number of milliseconds from 0 to a week
+            static bool milliseconds(const std::string& text, int64_t& ms) {
+                char* end;
+                errno = 0;
+                long long n = std::strtoll(text.c_str(), &end, 10);
+                if (text.empty() || *end != '\0' || errno != 0 || n < 0 || n > 7LL * 24 * 3600 * 1000) return false;
+                ms = n;
+                return true;
+            }
+
+            // Answer a line at once or post it to the worker of its game
+            void command(unsigned self, uint64_t token, Connection& c, const char* line, size_t length, unsigned& nextWorker) {
+                std::string word[4];
+                int count = words(line, length, word);
+                if (count == 0) return;
+                Command cmd = {};
+                cmd.token = token;
+                cmd.seq = c.nextSeq++;
+                cmd.loop = static_cast<uint16_t>(self);
+                const std::string& verb = word[0];
+                std::string refusal;
+                if (verb == "new" && count <= 3 && (count < 2 || milliseconds(word[1], cmd.baseMs)) &&
+                    (count < 3 || milliseconds(word[2], cmd.incMs))) {
+                    cmd.verb = NEW;
+                    Worker& w = *m_workers[nextWorker++ % workers()];
+                    if (w.control.push(cmd)) return nudge(w);
+                    refusal = "err 0 busy\n";
+                } else if (verb == "new") {
+                    refusal = "err 0 command\n";
+                } else {
+                    if (verb == "move" && count == 3) cmd.verb = MOVE;
+                    else if (verb == "show" && count == 2) cmd.verb = SHOW;
+                    else if (verb == "resign" && count == 2) cmd.verb = RESIGN;
+                    else if (verb == "close" && count == 2) cmd.verb = CLOSE;
+                    else refusal = "err 0 command\n";
+                }
+                if (refusal.empty()) {
+                    cmd.id = std::strtoull(word[1].c_str(), nullptr, 10);
+                    unsigned worker;
+                    uint32_t index;
+                    Slot* s = slot(cmd.id, worker, index);
+                    if (!s) GameSession::refuse(cmd.id, "unknown", refusal);
+                    else if (cmd.verb == MOVE && word[2].size() >= sizeof(cmd.move)) GameSession::refuse(cmd.id, "illegal", refusal);
+                    else {
+                        if (cmd.verb == MOVE) std::memcpy(cmd.move, word[2].c_str(), word[2].size() + 1);
+                        if (!s->mailbox.push(cmd)) GameSession::refuse(cmd.id, "busy", refusal);
+                        else if (!s->scheduled.exchange(true, std::memory_order_acq_rel)) {
+                            m_workers[worker]->runQueue.push(index);  // cannot fail, a slot is queued at most once
+                            nudge(*m_workers[worker]);
+                        }
+                    }
+                }
+                if (!refusal.empty()) deliver(c, cmd.seq, refusal.data(), refusal.size());
+            }
+
+            // ---- game workers ----
+
+            void work(unsigned self) {
+                Worker& w = *m_workers[self];
+                std::vector<bool> touched(m_loops.size());
+                std::string out;
+                for (;;) {
+                    bool busy = false;
+                    Command cmd;
+                    while (w.control.pop(cmd)) {
+                        busy = true;
+                        create(self, cmd, out, touched);
+                    }
+                    uint32_t index;
+                    for (int n = 0; n < 64 && w.runQueue.pop(index); ++n) {
+                        busy = true;
+                        Slot& s = w.chunks[index / CHUNK].load(std::memory_order_relaxed)[index % CHUNK];
+                        for (size_t taken = 0; taken < MAILBOX && s.mailbox.pop(cmd); ++taken) execute(self, index, s, cmd, out, touched);
+                        // mail posted after the mailbox looked empty finds scheduled false and queues the slot itself
+                        s.scheduled.exchange(false, std::memory_order_acq_rel);
+                        if (!s.mailbox.empty() && !s.scheduled.exchange(true, std::memory_order_acq_rel)) w.runQueue.push(index);
+                    }
+                    for (size_t i = 0; i < touched.size(); ++i) {
+                        if (!touched[i]) continue;
+                        touched[i] = false;
+                        notify(*m_loops[i]);
+                    }
+                    if (busy) continue;
+                    if (m_stopping) return;
+                    w.sleeping.store(true);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (!w.control.empty() || !w.runQueue.empty() || m_stopping) {
+                        w.sleeping.store(false);
+                        continue;
+                    }
+                    uint64_t count;
+                    ssize_t got = ::read(w.event, &count, sizeof(count));
+                    (void)got;
+                    w.sleeping.store(false);
+                }
+            }
+
+            // Wake an I/O thread for its replies, unless it has been woken and not looked yet
+            static void notify(Loop& l) {
+                if (l.notified.exchange(true, std::memory_order_acq_rel)) return;
+                uint64_t one = 1;
+                ssize_t written = ::write(l.event, &one, sizeof(one));
+                (void)written;
+            }
+
+            void reply(unsigned self, const Command& cmd, const std::string& text, std::vector<bool>& touched) {
+                Reply r;
+                r.token = cmd.token;
+                r.seq = cmd.seq;
+                r.length = static_cast<uint16_t>(std::min(text.size(), sizeof(r.text)));
+                std::memcpy(r.text, text.data(), r.length);
+                Loop& l = *m_loops[cmd.loop];
+                while (!l.replies[self]->push(r)) {
+                    // the I/O thread is behind: make sure it knows, and let it catch up
+                    notify(l);
+                    if (m_stopping) return;
+                    std::this_thread::yield();
+                }
+                touched[cmd.loop] = true;
+            }
+
+            void create(unsigned self, const Command& cmd, std::string& out, std::vector<bool>& touched) {
+                Worker& w = *m_workers[self];
+                uint32_t index;
+                if (!w.free.empty()) {
+                    index = w.free.back();
+                    w.free.pop_back();
+                } else if (w.allocated < MAX_GAMES) {
+                    index = w.allocated++;
+                    if (index % CHUNK == 0) {
+                        w.memory.emplace_back(new Slot[CHUNK]);
+                        w.chunks[index / CHUNK].store(w.memory.back().get(), std::memory_order_release);
+                    }
+                } else {
+                    return reply(self, cmd, "err 0 full\n", touched);
+                }
+                Slot& s = w.chunks[index / CHUNK].load(std::memory_order_relaxed)[index % CHUNK];
+                s.id = gameId(self, index, s.id >> 32);
+                s.open = true;
+                s.session = GameSession(cmd.baseMs, cmd.incMs);
+                m_games.fetch_add(1, std::memory_order_relaxed);
+                out = "game " + std::to_string(s.id) + "\n";
+                reply(self, cmd, out, touched);
+            }
+
+            void execute(unsigned self, uint32_t index, Slot& s, const Command& cmd, std::string& out, std::vector<bool>& touched) {
+                out.clear();
+                if (!s.open || s.id != cmd.id) GameSession::refuse(cmd.id, "unknown", out);
+                else if (cmd.verb == MOVE) s.session.play(cmd.id, cmd.move, out);
+                else if (cmd.verb == SHOW) s.session.show(cmd.id, out);
+                else if (cmd.verb == RESIGN) s.session.resign(cmd.id, out);
+                else {
+                    // the slot's next game gets the next generation, so this id stays unknown
+                    s.open = false;
+                    s.id = gameId(self, index, (s.id >> 32) + 1);
+                    m_workers[self]->free.push_back(index);
+                    out = "closed " + std::to_string(cmd.id) + "\n";
+                }
+                reply(self, cmd, out, touched);
+            }
+
+            std::vector<std::unique_ptr<Loop>> m_loops; //!the I/O threads
+            std::vector<std::unique_ptr<Worker>> m_workers; //!the game threads
+            int m_listen; //!listening socket shared by all loops
+            bool m_tcp = false; //!m_listen is a TCP socket
+            int m_wake; //!eventfd that stops every loop
+            std::atomic<bool> m_stopping; //!the loops are done, workers should finish
+            std::atomic<uint64_t> m_connections; //!accepted so far
+            std::atomic<uint64_t> m_commands; //!lines received so far
+            std::atomic<uint64_t> m_games; //!games made so far
+    };
+}
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef GUIENGINE_HH__
+#define GUIENGINE_HH__
+
+#include "Board.hh"
+#include "EnginePlayer.hh"
+#include <FL/Fl.H>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Runs the engine for an FLTK window without blocking its event loop
+     *
+     * The search runs on the EnginePlayer thread. Its progress is kept in one snapshot
+     * that the engine thread overwrites and the UI thread reads, and the engine thread
+     * wakes the event loop with Fl::awake only when no wakeup is outstanding. The UI side
+     * hands the snapshot to the window at most once per frame, so a fast search cannot
+     * flood the event queue and the window keeps repainting and taking clicks at full speed.
+     * Everything except the engine callbacks runs on the UI thread.
+     */
+    class GuiEngine{
+        public:
+            static constexpr double FRAME_SECONDS = 1.0 / 60;
+
+            /**
+             * @brief What the window shows about the search, a copy owned by the UI thread
+             */
+            struct Progress {
+                int depth = 0;
+                int score = 0;              // centipawns from the side to move, or a mate score
+                uint64_t nodes = 0;
+                int64_t timeMs = 0;
+                std::vector<Move> pv;
+                Move best;                  // the move played, once done
+                Move ponder;                // the reply expected to best, if any
+                bool done = false;          // the search has finished
+
+                /**
+                 * @brief Score as the GUI prints it: "+0.35" or "#3" / "#-2"
+                 */
+                std::string scoreString() const {
+                    if (Search::isMateScore(score)) return "#" + std::to_string(Search::mateInMoves(score));
+                    int cp = score < 0 ? -score : score;
+                    return std::string(score < 0 ? "-" : "+") + std::to_string(cp / 100) + (cp % 100 < 10 ? ".0" : ".") + std::to_string(cp % 100);
+                }
+
+                std::string pvString() const {
+                    std::string s;
+                    for (const Move& m : pv) s += (s.empty() ? "" : " ") + m.toString();
+                    return s;
+                }
+            };
+
+            // Called on the UI thread, at most once per frame
+            typedef std::function<void(const Progress&)> Handler;
+
+            explicit GuiEngine(Handler onProgress, size_t hashMb = 16)
+                : m_player(hashMb), m_onProgress(onProgress), m_posted(false), m_thinking(false) {
+                // the first lock turns on FLTK's thread support; the UI thread keeps it while running
+                static bool locked = (Fl::lock(), true);
+                (void)locked;
+                live().insert(this);
+            }
+
+            ~GuiEngine() {
+                m_player.cancel();
+                Fl::remove_timeout(deliver, this);
+                live().erase(this);
+            }
+
+            GuiEngine(const GuiEngine&) = delete;
+            GuiEngine& operator=(const GuiEngine&) = delete;
+
+            /**
+             * @brief Think on the opponent's time after each move: search the reply the engine
+             *        expects until the opponent moves
+             */
+            void setPonder(bool ponder) { m_player.setPonder(ponder); }
+
+            /**
+             * @brief Start searching the position; a ponder search on it carries on (a ponder hit,
+             *        returns true), any other search still running is dropped
+             */
+            bool go(const Board& position, const SearchLimits& limits) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_snapshot = Progress();
+                }
+                m_thinking = true;
+                bool hit = m_player.go(position, limits,
+                    [this](Move best, Move ponder) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_snapshot.best = best;
+                        m_snapshot.ponder = ponder;
+                        m_snapshot.done = true;
+                        post();
+                    },
+                    [this](const SearchInfo& info) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (m_snapshot.done) return;  // the ponder search after the move, not shown until a hit
+                        m_snapshot.depth = info.depth;
+                        m_snapshot.score = info.score;
+                        m_snapshot.nodes = info.nodes;
+                        m_snapshot.timeMs = info.timeMs;
+                        m_snapshot.pv = info.pv;
+                        post();
+                    });
+                return hit;
+            }
+
+            /**
+             * @brief The opponent played into position: stop pondering if it was not the expected reply
+             */
+            void opponentMoved(const Board& position) { m_player.opponentMoved(position); }
+
+            /**
+             * @brief Play the best move found so far as soon as possible
+             */
+            void moveNow() { m_player.search().stop(); }
+
+            /**
+             * @brief Stop searching, no more progress is delivered for this search
+             */
+            void cancel() {
+                m_player.cancel();
+                m_thinking = false;
+            }
+
+            bool thinking() const { return m_thinking; }
+
+        private:
+            typedef std::chrono::steady_clock Clock;
+
+            // Instances that may still receive a wakeup; only touched on the UI thread
+            static std::set<GuiEngine*>& live() {
+                static std::set<GuiEngine*> instances;
+                return instances;
+            }
+
+            // Engine thread, m_mutex held: wake the UI unless a wakeup is already on its way
+            void post() {
+                if (m_posted.exchange(true)) return;
+                if (Fl::awake(awakened, this) != 0) m_posted = false;  // queue full, the next report retries
+            }
+
+            // UI thread: deliver now, or at the start of the next frame
+            static void awakened(void* data) {
+                GuiEngine* self = static_cast<GuiEngine*>(data);
+                if (!live().count(self)) return;
+                double since = std::chrono::duration<double>(Clock::now() - self->m_lastDelivery).count();
+                if (since >= FRAME_SECONDS) deliver(self);
+                else if (!Fl::has_timeout(deliver, self)) Fl::add_timeout(FRAME_SECONDS - since, deliver, self);
+            }
+
+            static void deliver(void* data) {
+                GuiEngine* self = static_cast<GuiEngine*>(data);
+                Progress progress;
+                {
+                    std::lock_guard<std::mutex> lock(self->m_mutex);
+                    progress = self->m_snapshot;
+                    self->m_posted = false;
+                }
+                self->m_lastDelivery = Clock::now();
+                if (!self->m_thinking || (progress.depth == 0 && !progress.done)) return;  // cancelled, or a new search with nothing yet
+                if (progress.done) self->m_thinking = false;
+                if (self->m_onProgress) self->m_onProgress(progress);
+            }
+
+            EnginePlayer m_player; //!owns the engine thread
+            Handler m_onProgress; //!the window's update, on the UI thread
+            std::mutex m_mutex; //!guards the snapshot between the threads
+            Progress m_snapshot; //!latest progress, overwritten by the engine thread
+            std::atomic<bool> m_posted; //!a wakeup is queued and not yet delivered
+            bool m_thinking; //!UI side: a search was started and its result not yet delivered
+            Clock::time_point m_lastDelivery; //!when the window was last updated
+    };
+}
+
+#endif
@@ -0,0 +1,288 @@
+#include "Board.hh"
+#include "Notation.hh"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Load generator for Server: many clients playing random games at once
+ *
+ *   LoadTest [--port N | --unix PATH] [--clients C] [--games G] [--plies P] [--tc base+inc] [--san]
+ *
+ * Each client is a thread with one connection that plays G games side by side: every
+ * round it sends one random legal move for each of its games in a single write and
+ * then reads the replies. A game is closed when it ends or reaches P plies. Latency is
+ * the time from a round's write to the reply of each move. The client keeps its own
+ * board of every game and counts replies that do not match it.
+ */
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Options {
+        int port = 7777;
+        std::string unixPath;        // connect to this Unix socket instead of TCP
+        int clients = 8;
+        int games = 16;              // concurrent games per client
+        int plies = 200;             // close a game after this many plies
+        int64_t baseMs = 0, incMs = 0;  // untimed by default
+        bool san = false;            // send SAN instead of UCI moves
+    };
+
+    struct Result {
+        std::vector<double> latencyUs;
+        uint64_t games = 0, moves = 0, refused = 0, mismatches = 0;
+        bool failed = false;
+    };
+
+    int connectTo(const Options& opt) {
+        int fd;
+        if (opt.unixPath.empty()) {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(opt.port));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+        } else {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr = {};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, opt.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+        }
+        ::close(fd);
+        return -1;
+    }
+
+    /**
+     * @brief Blocking line reader and writer over a socket
+     */
+    class Connection{
+        public:
+            explicit Connection(int fd) : m_fd(fd) {}
+            ~Connection() { if (m_fd >= 0) ::close(m_fd); }
+
+            bool write(const std::string& data) {
+                for (size_t sent = 0; sent < data.size();) {
+                    ssize_t n = ::send(m_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                    if (n <= 0) return false;
+                    sent += static_cast<size_t>(n);
+                }
+                return true;
+            }
+
+            bool readLine(std::string& line) {
+                for (;;) {
+                    size_t end = m_buffer.find('\n', m_start);
+                    if (end != std::string::npos) {
+                        line.assign(m_buffer, m_start, end - m_start);
+                        m_start = end + 1;
+                        return true;
+                    }
+                    m_buffer.erase(0, m_start);
+                    m_start = 0;
+                    char chunk[4096];
+                    ssize_t n = ::recv(m_fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0) return false;
+                    m_buffer.append(chunk, static_cast<size_t>(n));
+                }
+            }
+
+        private:
+            int m_fd; //!the socket
+            std::string m_buffer; //!received bytes
+            size_t m_start = 0; //!first unread byte of m_buffer
+    };
+
+    struct Game {
+        uint64_t id = 0;
+        KS::Board board;
+        int plies = 0;
+        KS::Move sent;               // move awaiting its reply
+        bool closing = false;
+    };
+
+    void client(const Options& opt, unsigned seed, Result& result) {
+        Connection server(connectTo(opt));
+        std::mt19937 random(seed);
+        std::vector<Game> games(opt.games);
+        std::string batch, line;
+        for (int i = 0; i < opt.games; ++i) batch += "new " + std::to_string(opt.baseMs) + " " + std::to_string(opt.incMs) + "\n";
+        if (!server.write(batch)) {
+            result.failed = true;
+            return;
+        }
+        std::unordered_map<uint64_t, Game*> byId;
+        for (Game& g : games) {
+            unsigned long long id;
+            if (!server.readLine(line) || std::sscanf(line.c_str(), "game %llu", &id) != 1) {
+                result.failed = true;
+                return;
+            }
+            g.id = id;
+            byId[id] = &g;
+        }
+
+        while (!byId.empty()) {
+            batch.clear();
+            for (auto& entry : byId) {
+                Game& g = *entry.second;
+                KS::MoveList legal;
+                g.board.generateLegalMoves(legal);
+                g.closing = legal.size() == 0 || g.plies >= opt.plies;
+                if (g.closing) {
+                    batch += "close " + std::to_string(g.id) + "\n";
+                    continue;
+                }
+                g.sent = legal[static_cast<int>(random() % static_cast<unsigned>(legal.size()))];
+                std::string text = opt.san ? KS::Notation::san(g.board, g.sent) : g.sent.toString();
+                batch += "move " + std::to_string(g.id) + " " + text + "\n";
+            }
+            Clock::time_point sentAt = Clock::now();
+            if (!server.write(batch)) {
+                result.failed = true;
+                return;
+            }
+            for (size_t replies = byId.size(); replies > 0; --replies) {
+                if (!server.readLine(line)) {
+                    result.failed = true;
+                    return;
+                }
+                Clock::time_point now = Clock::now();
+                std::istringstream in(line);
+                std::string verb, state;
+                uint64_t id = 0;
+                in >> verb >> id;
+                auto it = byId.find(id);
+                if (it == byId.end()) {
+                    ++result.mismatches;
+                    continue;
+                }
+                Game& g = *it->second;
+                if (g.closing) {
+                    if (verb != "closed") ++result.mismatches;
+                    ++result.games;
+                    byId.erase(it);
+                    continue;
+                }
+                result.latencyUs.push_back(std::chrono::duration<double, std::micro>(now - sentAt).count());
+                if (verb != "ok") {
+                    ++result.refused;
+                    g.plies = opt.plies;  // close it next round
+                    continue;
+                }
+                int ply;
+                std::string san, white, black;
+                in >> ply >> san >> white >> black >> state;
+                if (san != KS::Notation::san(g.board, g.sent)) ++result.mismatches;
+                KS::Board::Undo u;
+                g.board.makeMove(g.sent, u);
+                ++g.plies;
+                ++result.moves;
+                if (ply != g.plies || (state == "ongoing") != (g.board.gameState() == KS::Board::ONGOING)) ++result.mismatches;
+                if (state != "ongoing") g.plies = opt.plies;
+            }
+        }
+    }
+
+    // The whole of text as a whole number between min and max
+    bool parseNumber(const std::string& text, long min, long max, long& n) {
+        char* end;
+        errno = 0;
+        n = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+    }
+
+    // The whole of text as a number of seconds, not negative
+    bool parseSeconds(const std::string& text, double& s) {
+        char* end;
+        s = std::strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && s >= 0 && s < 1e6;
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (flag == "--san") {
+                opt.san = true;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            long n = 0;
+            if (flag == "--port" && parseNumber(value, 1, 65535, n)) opt.port = static_cast<int>(n);
+            else if (flag == "--unix") opt.unixPath = value;
+            else if (flag == "--clients" && parseNumber(value, 1, 4096, n)) opt.clients = static_cast<int>(n);
+            else if (flag == "--games" && parseNumber(value, 1, 1 << 20, n)) opt.games = static_cast<int>(n);
+            else if (flag == "--plies" && parseNumber(value, 1, 1 << 16, n)) opt.plies = static_cast<int>(n);
+            else if (flag == "--tc") {
+                size_t plus = value.find('+');
+                double base = 0, inc = 0;
+                if (!parseSeconds(value.substr(0, plus), base)) return false;
+                if (plus != std::string::npos && !parseSeconds(value.substr(plus + 1), inc)) return false;
+                opt.baseMs = static_cast<int64_t>(base * 1000);
+                opt.incMs = static_cast<int64_t>(inc * 1000);
+            }
+            else return false;
+        }
+        return opt.clients > 0 && opt.games > 0 && opt.plies > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [--port N | --unix PATH] [--clients C] [--games G] [--plies P] [--tc seconds+inc] [--san]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results(opt.clients);
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> clients;
+    for (int c = 0; c < opt.clients; ++c) clients.emplace_back(client, std::cref(opt), 12345u + c, std::ref(results[c]));
+    for (auto& t : clients) t.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Result total;
+    int failed = 0;
+    for (Result& r : results) {
+        total.latencyUs.insert(total.latencyUs.end(), r.latencyUs.begin(), r.latencyUs.end());
+        total.games += r.games;
+        total.moves += r.moves;
+        total.refused += r.refused;
+        total.mismatches += r.mismatches;
+        failed += r.failed;
+    }
+    std::vector<double>& l = total.latencyUs;
+    std::sort(l.begin(), l.end());
+    auto percentile = [&](double p) { return l.empty() ? 0.0 : l[std::min(l.size() - 1, static_cast<size_t>(p * l.size()))]; };
+
+    std::printf("Clients %d, games %llu, moves %llu in %.2f s: %.0f moves/s\n", opt.clients, static_cast<unsigned long long>(total.games),
+                static_cast<unsigned long long>(total.moves), seconds, total.moves / seconds);
+    std::printf("Latency us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n", percentile(0.5), percentile(0.9), percentile(0.99),
+                percentile(0.999), l.empty() ? 0.0 : l.back());
+    std::printf("Refused %llu, mismatches %llu, failed connections %d\n", static_cast<unsigned long long>(total.refused),
+                static_cast<unsigned long long>(total.mismatches), failed);
+    return failed || total.mismatches ? 1 : 0;
+}
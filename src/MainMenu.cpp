@@ -2,6 +2,8 @@
 #include "Attributes.hh"
 #include "GUI.hh"
 #include "Window.hh"
+#include "SavedGame.hh"
+#include "BoardWindow.hh"
 #include <FL/Fl.H> 
 #include <FL/FL_draw.H> 
 #include <FL/FL_Widget.H> 
@@ -14,8 +16,11 @@ class MainMenu : public Fl_Window {
 private:
     Fl_Box *titleBox;        // Box to display the text "CHESS"
     Fl_Button *playButton;    // Button to start local multiplayer
+    Fl_Button *resumeButton;  // Button to continue the saved game
     Fl_Button *quitButton;    // Button to quit
 
+    KS::SavedGame saved;      // The last game, if there is one
+
 public:
     // Constructor for the Main Menu window
     MainMenu(int width, int height, const char* title) : Fl_Window(width, height, title) {
@@ -32,8 +37,13 @@ public:
         playButton = new Fl_Button(150, 200, 200, 40, "Play Local Multiplayer");
         playButton->callback(playButtonCallback, this);
 
+        // Resume Button, only usable when there is a saved game for this version
+        resumeButton = new Fl_Button(150, 255, 200, 40, "Resume");
+        resumeButton->callback(resumeButtonCallback, this);
+        if (!saved.load(KS::SavedGame::defaultPath())) resumeButton->deactivate();
+
         // Quit Button
-        quitButton = new Fl_Button(150, 270, 200, 40, "Quit");
+        quitButton = new Fl_Button(150, 310, 200, 40, "Quit");
         quitButton->callback(quitButtonCallback, this);
 
         // Show the window
@@ -49,6 +59,16 @@ public:
   
     }
 
+    // Callback for Resume button, the save was mapped when the menu opened
+    static void resumeButtonCallback(Fl_Widget* widget, void* data) {
+        MainMenu* menu = (MainMenu*)data;
+        if (!menu->saved.loaded()) return;
+        // the board copies the game out of the save, the menu stays behind it
+        BoardWindow* board = new BoardWindow({100, 100}, "Chess", &menu->saved);
+        board->show();
+        menu->hide();
+    }
+
     // Callback for Quit button
     static void quitButtonCallback(Fl_Widget* widget, void* data) {
         std::cout << "Quit button clicked\n";
@@ -0,0 +1,65 @@
+#ifndef MAPPEDFILE_HH__
+#define MAPPEDFILE_HH__
+
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief A read-only memory mapping of a whole file
+     *
+     * The mapping is released when the object is destroyed or another file is opened.
+     */
+    class MappedFile{
+        public:
+            MappedFile() : m_data(nullptr), m_size(0) {}
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile() {
+                close();
+            }
+
+            /**
+             * @brief Map a file, returns false if it cannot be opened or is empty
+             */
+            bool open(const std::string& path) {
+                close();
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) return false;
+                struct stat st;
+                if (fstat(fd, &st) != 0 || st.st_size == 0) {
+                    ::close(fd);
+                    return false;
+                }
+                void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (p == MAP_FAILED) return false;
+                m_data = static_cast<const unsigned char*>(p);
+                m_size = static_cast<size_t>(st.st_size);
+                return true;
+            }
+
+            void close() {
+                if (m_data != nullptr) munmap(const_cast<unsigned char*>(m_data), m_size);
+                m_data = nullptr;
+                m_size = 0;
+            }
+
+            bool isOpen() const { return m_data != nullptr; }
+            const unsigned char* data() const { return m_data; }
+            size_t size() const { return m_size; }
+
+        private:
+            const unsigned char* m_data; //!the start of the mapping
+            size_t m_size; //!the length of the mapping in bytes
+    };
+}
+
+#endif
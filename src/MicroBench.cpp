@@ -0,0 +1,276 @@
+#include "Board.hh"
+#include "Evaluation.hh"
+#include "Zobrist.hh"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Times the Board primitives one by one, so a slowdown can be traced to the part that caused it
+ *
+ *   MicroBench [--pinned [cpu]] [--samples N] [--json file] [--csv file] [--filter text]
+ *
+ * Every benchmark is run in samples of a fixed number of operations and reported as
+ * nanoseconds per operation (median, min, mean and spread of the kept samples).
+ * --pinned runs on one core after a warmup, takes more samples and drops the ones
+ * further than 3 (scaled) median absolute deviations from the median (interrupts, migrations).
+ * Bench.hh measures the whole engine; this measures its parts.
+ */
+namespace {
+
+    using KS::Board;
+
+    // Keeps the compiler from removing a result that is otherwise unused
+    template<typename T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "m"(value) : "memory");
+    }
+
+    struct Benchmark {
+        std::string name;
+        int opsPerCall;                   // operations done by one call of run
+        std::function<void()> run;
+    };
+
+    struct Measurement {
+        std::string name;
+        double median = 0, min = 0, mean = 0, stddev = 0;  // ns per operation
+        int samples = 0;                                    // kept after outlier rejection
+        int rejected = 0;
+    };
+
+    struct Options {
+        bool pinned = false;
+        int cpu = 0;
+        int samples = 15;
+        std::string json, csv, filter;
+    };
+
+    const char* const POSITIONS[] = {
+        Board::START_FEN,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // The whole of text as a whole number between min and max
+    bool parseNumber(const std::string& text, long min, long max, long& n) {
+        char* end;
+        errno = 0;
+        n = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+    }
+
+    bool pinToCpu(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    std::vector<Benchmark> benchmarks() {
+        std::vector<Benchmark> list;
+        static std::vector<Board> boards;
+        for (const char* fen : POSITIONS) boards.emplace_back(fen);
+        const int n = static_cast<int>(boards.size());
+
+        list.push_back({"board_construct", 1, []() { Board b; keep(b); }});
+        list.push_back({"board_copy", n, [n]() {
+            for (int i = 0; i < n; ++i) { Board b = boards[i]; keep(b); }
+        }});
+
+        // legal targets of every piece of one type for the side to move, in every position
+        static const std::pair<const char*, int> types[] = {
+            {"moves_pawn", KS::Piece::PAWN}, {"moves_knight", KS::Piece::KNIGHT}, {"moves_bishop", KS::Piece::BISHOP},
+            {"moves_rook", KS::Piece::ROOK}, {"moves_queen", KS::Piece::QUEEN}, {"moves_king", KS::Piece::KING}};
+        for (const auto& type : types) {
+            int pieces = 0;
+            for (const Board& b : boards) pieces += KS::popCount(b.pieces(b.sideToMove(), type.second));
+            int pieceType = type.second;
+            list.push_back({type.first, pieces > 0 ? pieces : 1, [pieceType]() {
+                for (Board& b : boards) {
+                    for (KS::Bitboard squares = b.pieces(b.sideToMove(), pieceType); squares; )
+                        keep(b.getAvailableMoves(KS::popLsb(squares)));
+                }
+            }});
+        }
+
+        list.push_back({"generate_legal", n, []() {
+            for (Board& b : boards) { KS::MoveList l; b.generateLegalMoves(l); keep(l.count); }
+        }});
+
+        // make and unmake every pseudo-legal move of every position
+        static std::vector<KS::MoveList> moves(boards.size());
+        int moveCount = 0;
+        for (int i = 0; i < n; ++i) {
+            boards[i].generatePseudoMoves(moves[i]);
+            moveCount += moves[i].size();
+        }
+        list.push_back({"make_unmake", moveCount, [n]() {
+            for (int i = 0; i < n; ++i) {
+                Board& b = boards[i];
+                for (const KS::Move& m : moves[i]) {
+                    Board::Undo u;
+                    b.makeMove(m, u);
+                    keep(b.zobrist());
+                    b.unmakeMove(m, u);
+                }
+            }
+        }});
+
+        // the incremental key update of a quiet move: piece out of from, into to, side flip
+        list.push_back({"zobrist_update", moveCount, [n]() {
+            uint64_t key = 0;
+            for (int i = 0; i < n; ++i) {
+                const Board& b = boards[i];
+                for (const KS::Move& m : moves[i]) {
+                    int piece = b.pieceAt(m.from());
+                    key ^= KS::Zobrist::piece(piece, m.from()) ^ KS::Zobrist::piece(piece, m.to()) ^ KS::Zobrist::side();
+                }
+            }
+            keep(key);
+        }});
+
+        list.push_back({"evaluate", n, []() {
+            for (const Board& b : boards) keep(KS::Evaluation::evaluate(b));
+        }});
+        list.push_back({"fen_parse", n, []() {
+            Board b;
+            for (const char* fen : POSITIONS) { b.setFen(fen); keep(b.zobrist()); }
+        }});
+        list.push_back({"fen_write", n, []() {
+            for (const Board& b : boards) { std::string fen = b.fen(); keep(fen.size()); }
+        }});
+        return list;
+    }
+
+    // Calls per sample so one sample takes about a millisecond
+    int calibrate(const Benchmark& bench) {
+        int calls = 1;
+        for (;;) {
+            int64_t start = nowNs();
+            for (int i = 0; i < calls; ++i) bench.run();
+            if (nowNs() - start >= 1000000 || calls >= (1 << 24)) return calls;
+            calls *= 2;
+        }
+    }
+
+    Measurement measure(const Benchmark& bench, const Options& options) {
+        if (options.pinned) {
+            int64_t until = nowNs() + 200000000;
+            while (nowNs() < until) bench.run();
+        }
+        int calls = calibrate(bench);
+        std::vector<double> samples;
+        for (int s = 0; s < options.samples; ++s) {
+            int64_t start = nowNs();
+            for (int i = 0; i < calls; ++i) bench.run();
+            samples.push_back(static_cast<double>(nowNs() - start) / (static_cast<double>(calls) * bench.opsPerCall));
+        }
+
+        Measurement result;
+        result.name = bench.name;
+        std::sort(samples.begin(), samples.end());
+        double median = samples[samples.size() / 2];
+        if (options.pinned) {
+            std::vector<double> deviations;
+            for (double x : samples) deviations.push_back(std::fabs(x - median));
+            std::sort(deviations.begin(), deviations.end());
+            double limit = 3 * 1.4826 * deviations[deviations.size() / 2];   // 3 standard deviations for normal noise
+            std::vector<double> kept;
+            for (double x : samples) if (std::fabs(x - median) <= limit) kept.push_back(x);
+            result.rejected = static_cast<int>(samples.size() - kept.size());
+            samples.swap(kept);
+        }
+
+        result.samples = static_cast<int>(samples.size());
+        result.median = samples[samples.size() / 2];
+        result.min = samples.front();
+        for (double x : samples) result.mean += x;
+        result.mean /= samples.size();
+        for (double x : samples) result.stddev += (x - result.mean) * (x - result.mean);
+        result.stddev = std::sqrt(result.stddev / samples.size());
+        return result;
+    }
+
+    void writeJson(const std::string& path, const std::vector<Measurement>& results, const Options& options) {
+        std::ofstream out(path);
+        out << "{\"pinned\":" << (options.pinned ? "true" : "false") << ",\"unit\":\"ns/op\",\"results\":[";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Measurement& m = results[i];
+            out << (i ? "," : "") << "\n {\"name\":\"" << m.name << "\",\"median\":" << m.median << ",\"min\":" << m.min
+                << ",\"mean\":" << m.mean << ",\"stddev\":" << m.stddev << ",\"samples\":" << m.samples
+                << ",\"rejected\":" << m.rejected << "}";
+        }
+        out << "\n]}\n";
+    }
+
+    void writeCsv(const std::string& path, const std::vector<Measurement>& results) {
+        std::ofstream out(path);
+        out << "name,median_ns,min_ns,mean_ns,stddev_ns,samples,rejected\n";
+        for (const Measurement& m : results)
+            out << m.name << "," << m.median << "," << m.min << "," << m.mean << "," << m.stddev << "," << m.samples << "," << m.rejected << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+        long n = 0;
+        if (arg == "--pinned" && (!hasValue || parseNumber(argv[i + 1], 0, 4095, n))) {
+            options.pinned = true;
+            options.samples = 51;
+            if (hasValue) options.cpu = static_cast<int>(n);
+            if (hasValue) ++i;
+        }
+        else if (arg == "--samples" && hasValue && parseNumber(argv[++i], 1, 100000, n)) options.samples = static_cast<int>(n);
+        else if (arg == "--json" && hasValue) options.json = argv[++i];
+        else if (arg == "--csv" && hasValue) options.csv = argv[++i];
+        else if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else {
+            std::cerr << "Usage: MicroBench [--pinned [cpu]] [--samples N] [--json file] [--csv file] [--filter text]" << std::endl;
+            return 1;
+        }
+    }
+    if (options.pinned && !pinToCpu(options.cpu)) std::cerr << "Could not pin to cpu " << options.cpu << ", running unpinned" << std::endl;
+
+    std::vector<Measurement> results;
+    std::cout << std::left << std::setw(18) << "benchmark" << std::right << std::setw(12) << "median ns" << std::setw(12) << "min ns"
+              << std::setw(12) << "stddev" << std::setw(10) << "samples" << std::endl;
+    for (const Benchmark& bench : benchmarks()) {
+        if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos) continue;
+        Measurement m = measure(bench, options);
+        results.push_back(m);
+        std::cout << std::left << std::setw(18) << m.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << m.median << std::setw(12) << m.min << std::setw(12) << m.stddev
+                  << std::setw(10) << m.samples << std::endl;
+    }
+
+    if (!options.json.empty()) writeJson(options.json, results, options);
+    if (!options.csv.empty()) writeCsv(options.csv, results);
+    return 0;
+}
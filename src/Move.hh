@@ -0,0 +1,94 @@
+#ifndef MOVE_HH__
+#define MOVE_HH__
+
+#include <cstdint>
+#include <string>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief A 16 bit chess move: 6 bits from square, 6 bits to square and 4 bits of flags
+     *
+     * Squares are numbered 0 (A1) to 63 (H8) like the Board array.
+     */
+    class Move{
+        public:
+            static const int QUIET = 0;
+            static const int DOUBLE_PUSH = 1;
+            static const int KING_CASTLE = 2;
+            static const int QUEEN_CASTLE = 3;
+            static const int CAPTURE = 4;
+            static const int EN_PASSANT = 5;
+            static const int PROMOTION = 8;      // promotion flags are PROMOTION | (0 knight, 1 bishop, 2 rook, 3 queen)
+            static const int PROMOTION_CAPTURE = 12;
+
+            Move() : data(0) {}
+            Move(int from, int to, int flags = QUIET)
+                : data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) {}
+
+            /** @brief Rebuild a move from its raw 16 bit encoding */
+            static Move fromRaw(uint16_t raw) { Move m; m.data = raw; return m; }
+
+            int from() const { return data & 0x3f; }
+            int to() const { return (data >> 6) & 0x3f; }
+            int flags() const { return data >> 12; }
+            uint16_t raw() const { return data; }
+
+            bool isNull() const { return data == 0; }
+            bool isCapture() const { return (flags() & CAPTURE) != 0; }
+            bool isPromotion() const { return (flags() & PROMOTION) != 0; }
+            bool isCastle() const { return flags() == KING_CASTLE || flags() == QUEEN_CASTLE; }
+
+            /** @brief The Piece type a pawn promotes to, Piece::NONE if it is not a promotion */
+            int promotionType() const {
+                static const int types[4] = {3, 5, 6, 7}; // KNIGHT, BISHOP, ROOK, QUEEN
+                return isPromotion() ? types[flags() & 3] : 0;
+            }
+
+            bool operator==(const Move& other) const { return data == other.data; }
+            bool operator!=(const Move& other) const { return data != other.data; }
+
+            /** @brief Long algebraic (UCI) text of the move, e.g. "e2e4" or "e7e8q" */
+            std::string toString() const {
+                if (isNull()) return "0000";
+                std::string s = squareName(from()) + squareName(to());
+                if (isPromotion()) s += "nbrq"[flags() & 3];
+                return s;
+            }
+
+            /** @brief Name of a square, e.g. 0 -> "a1" */
+            static std::string squareName(int square) {
+                return {static_cast<char>('a' + (square & 7)), static_cast<char>('1' + (square >> 3))};
+            }
+
+            /** @brief Parse a square name like "e4", -1 if invalid */
+            static int parseSquare(const std::string& name) {
+                if (name.size() < 2 || name[0] < 'a' || name[0] > 'h' || name[1] < '1' || name[1] > '8') return -1;
+                return (name[0] - 'a') + 8 * (name[1] - '1');
+            }
+
+        private:
+            uint16_t data;
+    };
+
+    /**
+     * @brief Fixed capacity list of moves filled by the move generator (no allocation)
+     */
+    struct MoveList{
+        static const int CAPACITY = 256;
+        Move moves[CAPACITY];
+        int count = 0;
+
+        void add(const Move& m) { moves[count++] = m; }
+        int size() const { return count; }
+        Move& operator[](int i) { return moves[i]; }
+        const Move& operator[](int i) const { return moves[i]; }
+        Move* begin() { return moves; }
+        Move* end() { return moves + count; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+    };
+}
+
+#endif
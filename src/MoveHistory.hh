@@ -0,0 +1,268 @@
+#ifndef MOVEHISTORY_HH__
+#define MOVEHISTORY_HH__
+
+#include "Widget.hh"
+#include "Window.hh"
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+#include <FL/fl_draw.H>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief A scrollable list of the moves of a game, one row per move pair: "12. Nf3 Nc6"
+     *
+     * The SAN of every ply is stored once, back to back in one string arena with a
+     * table of start offsets, so a game of any length costs two allocations and no
+     * per-move objects. Rows have a fixed height and are laid out arithmetically:
+     * a paint walks only the rows inside the visible window (and inside FLTK's clip),
+     * so drawing is the same cost at ply 10 as at ply 1000. Appending a move damages
+     * just its row.
+     *
+     * Scroll with the mouse wheel or by dragging in the bar on the right. Clicking a
+     * move calls the select handler with its ply (0 is White's first move).
+     */
+    class MoveHistory : public AUGL::Widget{
+        public:
+            static const int ROW_HEIGHT = 20;
+            static const int BAR_WIDTH = 10;
+            static const int WHEEL_ROWS = 3;
+
+            // Called with the ply of a clicked move
+            typedef std::function<void(int ply)> SelectHandler;
+
+            MoveHistory(const AUGL::Point& p, int width, int height)
+                : AUGL::Widget(p, width, height, {""}, nullptr), m_top(0), m_current(-1), m_follow(true), m_grab(-1), m_grabTop(0) {
+                m_starts.push_back(0);
+            }
+
+            void attach(AUGL::Window* window) override {
+                m_owner = window;
+                m_widget = new Canvas(*this);
+            }
+
+            void draw() override { m_widget->draw(); }
+
+            void onSelect(SelectHandler handler) { m_onSelect = handler; }
+
+            int plies() const { return static_cast<int>(m_starts.size()) - 1; }
+
+            /**
+             * @brief SAN of a ply
+             */
+            std::string san(int ply) const {
+                return m_arena.substr(m_starts[ply], m_starts[ply + 1] - m_starts[ply]);
+            }
+
+            /**
+             * @brief The moves as numbered text, "1. e4 e5 2. Nf3"
+             */
+            std::string text() const {
+                std::string s;
+                for (int ply = 0; ply < plies(); ++ply) {
+                    if (ply % 2 == 0) s += (ply ? " " : "") + std::to_string(ply / 2 + 1) + ".";
+                    s += " " + san(ply);
+                }
+                return s;
+            }
+
+            /**
+             * @brief Append the next ply; the list keeps showing the end if it was showing it
+             */
+            void push(const std::string& san) {
+                m_arena += san;
+                m_starts.push_back(static_cast<uint32_t>(m_arena.size()));
+                if (m_follow && scrollTo(maxTop())) return;
+                damageRow((plies() - 1) / 2);
+                damageBar();
+            }
+
+            /**
+             * @brief Keep only the first plies moves, for takebacks and new games
+             */
+            void truncate(int count) {
+                if (count >= plies()) return;
+                m_arena.resize(m_starts[count]);
+                m_starts.resize(count + 1);
+                if (m_current >= count) m_current = -1;
+                if (!scrollTo(m_top)) damageAll();
+            }
+
+            void clear() { truncate(0); }
+
+            /**
+             * @brief Show a saved list: count plies whose SAN starts at the offsets into text
+             */
+            void restore(const char* text, const uint32_t* starts, int count) {
+                m_arena.assign(text, starts[count]);
+                m_starts.assign(starts, starts + count + 1);
+                m_current = -1;
+                m_top = maxTop();
+                m_follow = true;
+                damageAll();
+            }
+
+            // The SAN text and its offsets, e.g. for a save file
+            const std::string& arena() const { return m_arena; }
+            const std::vector<uint32_t>& starts() const { return m_starts; }
+
+            /**
+             * @brief Highlight a ply, -1 for none
+             */
+            void setCurrent(int ply) {
+                if (ply == m_current) return;
+                if (m_current >= 0) damageRow(m_current / 2);
+                m_current = ply;
+                if (ply < 0) return;
+                damageRow(ply / 2);
+                int row = ply / 2;
+                if (row * ROW_HEIGHT < m_top) scrollTo(row * ROW_HEIGHT);
+                else if ((row + 1) * ROW_HEIGHT > m_top + listHeight()) scrollTo((row + 1) * ROW_HEIGHT - listHeight());
+            }
+
+        private:
+            /**
+             * @brief The FLTK widget that paints and takes the events of the list
+             */
+            class Canvas : public Fl_Widget{
+                public:
+                    explicit Canvas(MoveHistory& view) : Fl_Widget(view.x(), view.y(), view.w(), view.h()), m_view(view) {}
+                    void draw() override { m_view.paint(); }
+                    int handle(int event) override { return m_view.handleEvent(event); }
+                private:
+                    MoveHistory& m_view; //!the list this draws
+            };
+
+            int rows() const { return (plies() + 1) / 2; }
+            int listHeight() const { return m_height; }
+            int maxTop() const {
+                int top = rows() * ROW_HEIGHT - listHeight();
+                return top > 0 ? top : 0;
+            }
+
+            // Scroll so the list starts top pixels down, false if nothing moved
+            bool scrollTo(int top) {
+                if (top > maxTop()) top = maxTop();
+                if (top < 0) top = 0;
+                m_follow = top == maxTop();
+                if (top == m_top) return false;
+                m_top = top;
+                damageAll();
+                return true;
+            }
+
+            void damageAll() {
+                if (m_widget) m_widget->damage(FL_DAMAGE_USER1, x(), y(), w(), h());
+            }
+
+            void damageRow(int row) {
+                int ry = y() + row * ROW_HEIGHT - m_top;
+                if (m_widget && ry + ROW_HEIGHT > y() && ry < y() + h()) m_widget->damage(FL_DAMAGE_USER1, x(), ry, w() - BAR_WIDTH, ROW_HEIGHT);
+            }
+
+            void damageBar() {
+                if (m_widget) m_widget->damage(FL_DAMAGE_USER1, x() + w() - BAR_WIDTH, y(), BAR_WIDTH, h());
+            }
+
+            // Ply under a point in the list, -1 if none
+            int plyAt(int px, int py) const {
+                if (px < x() || px >= x() + w() - BAR_WIDTH || py < y() || py >= y() + h()) return -1;
+                int row = (py - y() + m_top) / ROW_HEIGHT;
+                int column = px - x() < numberWidth() + moveWidth() ? 0 : 1;
+                int ply = row * 2 + column;
+                return px - x() >= numberWidth() && ply < plies() ? ply : -1;
+            }
+
+            int numberWidth() const { return 40; }
+            int moveWidth() const { return (w() - BAR_WIDTH - numberWidth()) / 2; }
+
+            int handleEvent(int event) {
+                switch (event) {
+                    case FL_PUSH: {
+                        if (Fl::event_x() >= x() + w() - BAR_WIDTH) {
+                            m_grab = Fl::event_y();
+                            m_grabTop = m_top;
+                            return 1;
+                        }
+                        int ply = plyAt(Fl::event_x(), Fl::event_y());
+                        if (ply >= 0 && m_onSelect) m_onSelect(ply);
+                        return 1;
+                    }
+                    case FL_DRAG:
+                        if (m_grab >= 0 && h() > 0) scrollTo(m_grabTop + (Fl::event_y() - m_grab) * rows() * ROW_HEIGHT / h());
+                        return 1;
+                    case FL_RELEASE:
+                        m_grab = -1;
+                        return 1;
+                    case FL_MOUSEWHEEL:
+                        scrollTo(m_top + Fl::event_dy() * WHEEL_ROWS * ROW_HEIGHT);
+                        return 1;
+                }
+                return 0;
+            }
+
+            void paint() {
+                fl_push_clip(x(), y(), w(), h());
+                int first = m_top / ROW_HEIGHT;
+                int last = (m_top + listHeight() - 1) / ROW_HEIGHT;
+                fl_font(FL_HELVETICA, ROW_HEIGHT * 3 / 5);
+                int baseline = (ROW_HEIGHT + fl_height()) / 2 - fl_descent();
+                char number[16];
+                for (int row = first; row <= last; ++row) {
+                    int ry = y() + row * ROW_HEIGHT - m_top;
+                    if (!fl_not_clipped(x(), ry, w() - BAR_WIDTH, ROW_HEIGHT)) continue;
+                    fl_rectf(x(), ry, w() - BAR_WIDTH, ROW_HEIGHT, row % 2 ? ODD : EVEN);
+                    if (row >= rows()) continue;
+                    int length = std::snprintf(number, sizeof(number), "%d.", row + 1);
+                    fl_color(NUMBER);
+                    fl_draw(number, length, x() + 4, ry + baseline);
+                    for (int column = 0; column < 2; ++column) {
+                        int ply = row * 2 + column;
+                        if (ply >= plies()) break;
+                        int mx = x() + numberWidth() + column * moveWidth();
+                        if (ply == m_current) fl_rectf(mx, ry, moveWidth(), ROW_HEIGHT, CURRENT);
+                        fl_color(FL_BLACK);
+                        fl_draw(m_arena.data() + m_starts[ply], static_cast<int>(m_starts[ply + 1] - m_starts[ply]), mx + 4, ry + baseline);
+                    }
+                }
+                paintBar();
+                fl_pop_clip();
+            }
+
+            void paintBar() {
+                int bx = x() + w() - BAR_WIDTH;
+                if (!fl_not_clipped(bx, y(), BAR_WIDTH, h())) return;
+                fl_rectf(bx, y(), BAR_WIDTH, h(), BAR);
+                int content = rows() * ROW_HEIGHT;
+                if (content <= listHeight()) return;
+                int thumb = h() * listHeight() / content;
+                if (thumb < 10) thumb = 10;
+                int ty = y() + static_cast<int>(static_cast<long long>(h() - thumb) * m_top / maxTop());
+                fl_rectf(bx + 2, ty, BAR_WIDTH - 4, thumb, THUMB);
+            }
+
+            static const Fl_Color EVEN = 0xFFFFFF00;    // RGB colors are 0xRRGGBB00
+            static const Fl_Color ODD = 0xF0F0F000;
+            static const Fl_Color NUMBER = 0x80808000;
+            static const Fl_Color CURRENT = 0xF6F66900;
+            static const Fl_Color BAR = 0xE0E0E000;
+            static const Fl_Color THUMB = 0xA0A0A000;
+
+            std::string m_arena; //!SAN of every ply, back to back
+            std::vector<uint32_t> m_starts; //!offset of every ply in m_arena, plus the end
+            int m_top; //!pixels of the list scrolled above the widget
+            int m_current; //!highlighted ply, -1 for none
+            bool m_follow; //!showing the end, so new moves scroll into view
+            int m_grab; //!pointer y where the scroll bar was grabbed, -1 if it is not held
+            int m_grabTop; //!m_top when the scroll bar was grabbed
+            SelectHandler m_onSelect; //!called with a clicked ply
+    };
+}
+
+#endif
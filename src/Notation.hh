@@ -0,0 +1,342 @@
+#ifndef NOTATION_HH__
+#define NOTATION_HH__
+
+#include "Attacks.hh"
+#include "Board.hh"
+#include "Move.hh"
+#include "Piece.hh"
+#include <cctype>
+#include <string>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Standard algebraic notation (SAN) of moves, e.g. "Nbd7", "exd6", "O-O+", "e8=Q#",
+     *        and a parser for SAN and long algebraic text ("e2e4", "e7e8q", "Ng1-f3")
+     *
+     * Nothing here generates move lists or plays trial moves. Both directions work on a
+     * copy of the position's bitboards: the pieces that could make a move are the
+     * intersection of the mover's pieces with the attacks from the target square, and
+     * legality comes from the pin mask and the check mask of the side to move. Check and
+     * mate suffixes come from playing the move on the copy and looking for checkers and
+     * for any evasion (king step, capture of the checker, block) the same way.
+     */
+    class Notation{
+        public:
+            /**
+             * @brief SAN of a legal move in a position
+             */
+            static std::string san(const Board& board, const Move& move) {
+                std::string s;
+                if (move.flags() == Move::KING_CASTLE) s = "O-O";
+                else if (move.flags() == Move::QUEEN_CASTLE) s = "O-O-O";
+                else {
+                    int type = Piece::PieceType(board.pieceAt(move.from()));
+                    if (type == Piece::PAWN) {
+                        if (move.isCapture()) s += static_cast<char>('a' + move.from() % 8);
+                    } else {
+                        s += letter(type);
+                        s += disambiguation(Snapshot(board), move, type);
+                    }
+                    if (move.isCapture()) s += 'x';
+                    s += Move::squareName(move.to());
+                    if (move.isPromotion()) {
+                        s += '=';
+                        s += letter(move.promotionType());
+                    }
+                }
+
+                Snapshot after(board);
+                after.play(move);
+                if (after.checkers) s += after.canEscapeCheck() ? '+' : '#';
+                return s;
+            }
+
+            /**
+             * @brief The legal move written as SAN or long algebraic text, null if there is none
+             *        or the text is ambiguous
+             *
+             * Check, mate and annotation marks are ignored, as are "x", "-" and "=".
+             * Castling may be written with letter O or digit 0.
+             */
+            static Move parse(const Board& board, const std::string& text) {
+                std::string s;
+                for (char c : text) {
+                    if (c == '+' || c == '#' || c == '!' || c == '?' || c == 'x' || c == '-' || c == '=') continue;
+                    s += c;
+                }
+                Snapshot pos(board);
+                if (s == "OO" || s == "00") return castle(board, pos, true);
+                if (s == "OOO" || s == "000") return castle(board, pos, false);
+
+                // [piece][from file][from rank]<to square>[promotion]
+                int type = Piece::PAWN;
+                size_t at = 0;
+                if (!s.empty() && letterType(s[0]) != Piece::NONE) type = letterType(s[at++]);
+                int promotion = Piece::NONE;
+                if (s.size() > at + 2 && type == Piece::PAWN && std::isalpha(static_cast<unsigned char>(s.back()))) {
+                    promotion = letterType(static_cast<char>(std::toupper(static_cast<unsigned char>(s.back()))));
+                    if (promotion == Piece::NONE || promotion == Piece::PAWN || promotion == Piece::KING) return Move();
+                    s.pop_back();
+                }
+                if (s.size() < at + 2) return Move();
+                int to = Move::parseSquare(s.substr(s.size() - 2));
+                if (to < 0) return Move();
+                Bitboard fromMask = ~0ULL;
+                for (size_t i = at; i + 2 < s.size(); ++i) {
+                    if (s[i] >= 'a' && s[i] <= 'h') fromMask &= Attacks::FILE_A << (s[i] - 'a');
+                    else if (s[i] >= '1' && s[i] <= '8') fromMask &= Attacks::RANK_1 << (8 * (s[i] - '1'));
+                    else return Move();
+                }
+
+                // long algebraic text names the from square but not always the piece
+                bool oneSquare = !(fromMask & (fromMask - 1));
+                if (at == 0 && oneSquare && (pos.colors[pos.side] & fromMask)) type = Piece::PieceType(board.pieceAt(lsb(fromMask)));
+
+                // a king moving two squares, "e1g1", is castling
+                int king = pos.kingSquare(pos.side);
+                if (type == Piece::KING && oneSquare && fromMask == bit(king) && (to == king + 2 || to == king - 2))
+                    return castle(board, pos, to == king + 2);
+
+                int us = pos.side;
+                Bitboard own = pos.colors[us], enemy = pos.colors[us ^ 1];
+                if (own & bit(to)) return Move();
+                Bitboard candidates = pos.pieces[us][type] & fromMask & reaching(pos, type, to);
+                Move found;
+                while (candidates) {
+                    int from = popLsb(candidates);
+                    bool enPassant = type == Piece::PAWN && to == pos.ep && (from & 7) != (to & 7);
+                    if (!pos.legal(from, to, type, enPassant)) continue;
+                    if (!found.isNull()) return Move();  // two pieces fit the text
+                    int flags = enemy & bit(to) ? Move::CAPTURE : Move::QUIET;
+                    if (enPassant) flags = Move::EN_PASSANT;
+                    else if (type == Piece::PAWN && (to - from == 16 || from - to == 16)) flags = Move::DOUBLE_PUSH;
+                    else if (type == Piece::PAWN && (to >= 56 || to < 8)) flags |= Move::PROMOTION | promotionIndex(promotion == Piece::NONE ? Piece::QUEEN : promotion);
+                    found = Move(from, to, flags);
+                }
+                if (promotion != Piece::NONE && !found.isPromotion()) return Move();
+                return found;
+            }
+
+            /**
+             * @brief Upper case letter of a piece type, as SAN writes it
+             */
+            static char letter(int type) {
+                switch (type) {
+                    case Piece::KING: return 'K';
+                    case Piece::QUEEN: return 'Q';
+                    case Piece::ROOK: return 'R';
+                    case Piece::BISHOP: return 'B';
+                    case Piece::KNIGHT: return 'N';
+                    default: return 'P';
+                }
+            }
+
+        private:
+            static Bitboard bit(int square) { return 1ULL << square; }
+
+            static int letterType(char c) {
+                switch (c) {
+                    case 'K': return Piece::KING;
+                    case 'Q': return Piece::QUEEN;
+                    case 'R': return Piece::ROOK;
+                    case 'B': return Piece::BISHOP;
+                    case 'N': return Piece::KNIGHT;
+                    case 'P': return Piece::PAWN;
+                    default: return Piece::NONE;
+                }
+            }
+
+            // Low bits of the promotion flags, see Move::PROMOTION
+            static int promotionIndex(int type) {
+                switch (type) {
+                    case Piece::KNIGHT: return 0;
+                    case Piece::BISHOP: return 1;
+                    case Piece::ROOK: return 2;
+                    default: return 3;
+                }
+            }
+
+            /**
+             * @brief The bitboards of a position, cheap to play a move on without touching the Board
+             */
+            struct Snapshot {
+                Bitboard pieces[2][8];  // by color index and piece type
+                Bitboard colors[2];
+                Bitboard occupied;
+                int side;               // color index of the side to move
+                int ep;                 // en passant target square, -1 if none
+                Bitboard checkers;      // pieces giving check to the side to move
+                Bitboard pinned;        // pieces of the side to move pinned to their king
+                Bitboard checkMask;     // where a non-king move must land: anywhere, the checker or a block, or nowhere in double check
+
+                explicit Snapshot(const Board& board) {
+                    for (int c = 0; c < 2; ++c) {
+                        int color = c == 0 ? Piece::WHITE : Piece::BLACK;
+                        for (int type = 0; type < 8; ++type) pieces[c][type] = board.pieces(color, type);
+                        colors[c] = board.pieces(color);
+                    }
+                    occupied = colors[0] | colors[1];
+                    side = Piece::ColorIndex(board.sideToMove());
+                    ep = board.enPassantSquare();
+                    refresh();
+                }
+
+                int kingSquare(int c) const { return lsb(pieces[c][Piece::KING]); }
+
+                // Pieces of color index by that attack a square with the given occupancy
+                Bitboard attackers(int square, Bitboard occ, int by) const {
+                    const Bitboard* p = pieces[by];
+                    return (Attacks::pawn(by ^ 1, square) & p[Piece::PAWN])
+                         | (Attacks::knight(square) & p[Piece::KNIGHT])
+                         | (Attacks::king(square) & p[Piece::KING])
+                         | (Attacks::rook(square, occ) & (p[Piece::ROOK] | p[Piece::QUEEN]))
+                         | (Attacks::bishop(square, occ) & (p[Piece::BISHOP] | p[Piece::QUEEN]));
+                }
+
+                // Checkers, pins and the check mask of the side to move
+                void refresh() {
+                    int king = kingSquare(side), them = side ^ 1;
+                    checkers = attackers(king, occupied, them);
+                    pinned = 0;
+                    Bitboard snipers = (Attacks::rook(king, 0) & (pieces[them][Piece::ROOK] | pieces[them][Piece::QUEEN]))
+                                     | (Attacks::bishop(king, 0) & (pieces[them][Piece::BISHOP] | pieces[them][Piece::QUEEN]));
+                    while (snipers) {
+                        Bitboard blockers = Attacks::between(king, popLsb(snipers)) & occupied;
+                        if (blockers && !(blockers & (blockers - 1))) pinned |= blockers & colors[side];
+                    }
+                    if (!checkers) checkMask = ~0ULL;
+                    else if (checkers & (checkers - 1)) checkMask = 0;
+                    else checkMask = checkers | Attacks::between(king, lsb(checkers));
+                }
+
+                /**
+                 * @brief Is a pseudo-legal move of the side to move (not castling) legal
+                 */
+                bool legal(int from, int to, int type, bool enPassant) const {
+                    int king = kingSquare(side);
+                    if (type == Piece::KING) return !attackers(to, occupied ^ bit(from), side ^ 1);
+                    if (enPassant) {
+                        int captured = side == 0 ? to - 8 : to + 8;
+                        Bitboard occ = (occupied ^ bit(from) ^ bit(captured)) | bit(to);
+                        return !(attackers(king, occ, side ^ 1) & ~bit(captured));
+                    }
+                    if (!(checkMask & bit(to))) return false;
+                    // a pinned piece stays on the line through its king
+                    return !(pinned & bit(from)) || (Attacks::between(king, to) & bit(from)) || (Attacks::between(king, from) & bit(to));
+                }
+
+                /**
+                 * @brief Play a legal move, the other side is to move afterwards
+                 */
+                void play(const Move& move) {
+                    int from = move.from(), to = move.to(), them = side ^ 1;
+                    int type = Piece::NONE;
+                    for (int t = 0; t < 8; ++t) if (pieces[side][t] & bit(from)) type = t;
+                    int captured = move.flags() == Move::EN_PASSANT ? (side == 0 ? to - 8 : to + 8) : to;
+                    for (Bitboard& b : pieces[them]) b &= ~bit(captured);
+                    colors[them] &= ~bit(captured);
+                    pieces[side][type] ^= bit(from);
+                    pieces[side][move.isPromotion() ? move.promotionType() : type] |= bit(to);
+                    colors[side] ^= bit(from) | bit(to);
+                    if (move.isCastle()) {
+                        bool kingside = move.flags() == Move::KING_CASTLE;
+                        Bitboard rook = bit(kingside ? from + 3 : from - 4) | bit(kingside ? from + 1 : from - 1);
+                        pieces[side][Piece::ROOK] ^= rook;
+                        colors[side] ^= rook;
+                    }
+                    occupied = colors[0] | colors[1];
+                    ep = move.flags() == Move::DOUBLE_PUSH ? (from + to) / 2 : -1;
+                    side = them;
+                    refresh();
+                }
+
+                /**
+                 * @brief Does the side to move, which is in check, have a legal move
+                 */
+                bool canEscapeCheck() const {
+                    int king = kingSquare(side);
+                    Bitboard steps = Attacks::king(king) & ~colors[side];
+                    while (steps) if (legal(king, popLsb(steps), Piece::KING, false)) return true;
+
+                    // capture the checker or block it, never both checkers at once
+                    Bitboard targets = checkMask;
+                    while (targets) {
+                        int to = popLsb(targets);
+                        Bitboard movers = 0;
+                        for (int type : {Piece::PAWN, Piece::KNIGHT, Piece::BISHOP, Piece::ROOK, Piece::QUEEN})
+                            movers |= pieces[side][type] & reaching(*this, type, to);
+                        if (to == ep) movers &= ~Attacks::pawn(side ^ 1, ep);  // en passant is tried below
+                        movers &= ~pinned;  // a pinned piece cannot stop a check from another piece
+                        if (movers) return true;
+                    }
+                    if (ep >= 0) {
+                        Bitboard pawns = Attacks::pawn(side ^ 1, ep) & pieces[side][Piece::PAWN];
+                        while (pawns) if (legal(popLsb(pawns), ep, Piece::PAWN, true)) return true;
+                    }
+                    return false;
+                }
+            };
+
+            /**
+             * @brief Squares from which a piece of the side to move and the given type could move
+             *        to a square, ignoring legality; en passant counts for pawns
+             */
+            static Bitboard reaching(const Snapshot& pos, int type, int to) {
+                int us = pos.side;
+                switch (type) {
+                    case Piece::KNIGHT: return Attacks::knight(to);
+                    case Piece::BISHOP: return Attacks::bishop(to, pos.occupied);
+                    case Piece::ROOK: return Attacks::rook(to, pos.occupied);
+                    case Piece::QUEEN: return Attacks::queen(to, pos.occupied);
+                    case Piece::KING: return Attacks::king(to);
+                    case Piece::PAWN: {
+                        if (pos.colors[us ^ 1] & bit(to)) return Attacks::pawn(us ^ 1, to);
+                        if (pos.occupied & bit(to)) return 0;
+                        Bitboard captures = to == pos.ep ? Attacks::pawn(us ^ 1, to) : 0;
+                        int back = us == 0 ? -8 : 8;
+                        int one = to + back;
+                        if (one < 0 || one > 63) return captures;
+                        if (pos.occupied & bit(one)) return captures | bit(one);
+                        int doubleRank = us == 0 ? 3 : 4;
+                        return captures | (to / 8 == doubleRank ? bit(one + back) : 0);
+                    }
+                    default: return 0;
+                }
+            }
+
+            // File, rank or both of the from square when another piece of the type can reach the target
+            static std::string disambiguation(const Snapshot& pos, const Move& move, int type) {
+                Bitboard others = pos.pieces[pos.side][type] & reaching(pos, type, move.to()) & ~bit(move.from());
+                bool other = false, sameFile = false, sameRank = false;
+                while (others) {
+                    int from = popLsb(others);
+                    if (!pos.legal(from, move.to(), type, false)) continue;
+                    other = true;
+                    sameFile = sameFile || from % 8 == move.from() % 8;
+                    sameRank = sameRank || from / 8 == move.from() / 8;
+                }
+                std::string square = Move::squareName(move.from());
+                if (!other) return "";
+                if (!sameFile) return square.substr(0, 1);
+                if (!sameRank) return square.substr(1, 1);
+                return square;
+            }
+
+            // Castling, if the rights, the empty path and the unattacked squares allow it
+            static Move castle(const Board& board, const Snapshot& pos, bool kingside) {
+                int king = pos.kingSquare(pos.side);
+                int right = pos.side == 0 ? (kingside ? Board::WHITE_KINGSIDE : Board::WHITE_QUEENSIDE)
+                                          : (kingside ? Board::BLACK_KINGSIDE : Board::BLACK_QUEENSIDE);
+                int rook = kingside ? king + 3 : king - 4;
+                int to = kingside ? king + 2 : king - 2;
+                if (!(board.castling() & right) || pos.checkers || (Attacks::between(king, rook) & pos.occupied)) return Move();
+                for (int sq : {(king + to) / 2, to})
+                    if (pos.attackers(sq, pos.occupied, pos.side ^ 1)) return Move();
+                return Move(king, to, kingside ? Move::KING_CASTLE : Move::QUEEN_CASTLE);
+            }
+    };
+}
+
+#endif
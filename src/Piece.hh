@@ -0,0 +1,95 @@
+#ifndef Piece_HH__
+#define Piece_HH__
+
+#include <climits>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief An bit representation of chess pieces
+     */
+    class Piece{
+        public:
+            static const int NONE = 0;
+            static const int KING = 1;
+            static const int PAWN = 2;
+            static const int KNIGHT = 3;
+            static const int BISHOP = 5;
+            static const int ROOK = 6;
+            static const int QUEEN = 7;
+
+            static const int WHITE = 8;
+            static const int BLACK = 16;
+
+            static const int pieceMask = 0b00111;
+            static const int whiteMask = 0b01000;
+            static const int blackMask = 0b10000;
+            static const int colorMask = 0b11000;
+
+            static bool isColor(int piece, int color){
+                return (piece & colorMask) == color;
+            }
+
+            static int Color(int piece){
+                return (piece & colorMask);
+            }
+            
+            static int PieceType(int piece){
+                return (piece & pieceMask);
+            }
+
+            static bool IsRookOrQueen (int piece) {
+			    return (piece & 0b110) == 0b110;
+		    }
+
+		    static bool IsBishopOrQueen (int piece) {
+			    return (piece & 0b101) == 0b101;
+		    }
+
+		    static bool IsSlidingPiece (int piece) {
+			    return (piece & 0b100) != 0;
+		    } 
+
+            /**
+             * @brief 0 for white and 1 for black, used to index per-color tables
+             */
+            static int ColorIndex(int color){
+                return color == BLACK ? 1 : 0;
+            }
+
+            /**
+             * @brief The other side's color
+             */
+            static int Opposite(int color){
+                return color ^ colorMask;
+            }
+
+            /**
+             * @brief FEN letter of a piece, uppercase for white and lowercase for black
+             */
+            static char ToChar(int piece){
+                static const char letters[8] = {' ', 'k', 'p', 'n', ' ', 'b', 'r', 'q'};
+                char c = letters[PieceType(piece)];
+                return isColor(piece, WHITE) ? static_cast<char>(c - 'a' + 'A') : c;
+            }
+
+            /**
+             * @brief Parse a FEN letter into a piece, NONE if it is not a piece letter
+             */
+            static int FromChar(char c){
+                int color = (c >= 'A' && c <= 'Z') ? WHITE : BLACK;
+                switch (c | 0x20) {
+                    case 'k': return KING | color;
+                    case 'p': return PAWN | color;
+                    case 'n': return KNIGHT | color;
+                    case 'b': return BISHOP | color;
+                    case 'r': return ROOK | color;
+                    case 'q': return QUEEN | color;
+                    default: return NONE;
+                }
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,272 @@
+#ifndef PIECEATLAS_HH__
+#define PIECEATLAS_HH__
+
+#include "MappedFile.hh"
+#include "Piece.hh"
+#include <FL/Fl.H>
+#include <FL/Fl_Image.H>
+#if FL_API_VERSION >= 10400
+#include <FL/Fl_SVG_Image.H>
+#endif
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief All twelve pieces in one image, rasterized from the SVG asset at one square size
+     *
+     * The atlas has a row per color and a column per piece type, each cell one square.
+     * It is cached as a raw RGBA file named after the cell size in pixels and a hash of
+     * the SVG, so a later start with the same size and asset maps the file and draws
+     * from the mapping with no decoding. A missing or stale file is rasterized again
+     * (this needs FLTK 1.4 for Fl_SVG_Image) and written for next time.
+     * Pieces are drawn as sub-rectangle blits of the one image.
+     */
+    class PieceAtlas{
+        public:
+            static const int COLUMNS = 6;
+            static const int ROWS = 2;
+            static const uint32_t VERSION = 1;
+
+            PieceAtlas() : m_image(nullptr), m_size(0) {}
+
+            ~PieceAtlas() {
+                delete m_image;
+            }
+
+            PieceAtlas(const PieceAtlas&) = delete;
+            PieceAtlas& operator=(const PieceAtlas&) = delete;
+
+            /**
+             * @brief Make the atlas for squares of size FLTK units and pixels screen pixels,
+             *        from the cache if possible. Returns false if it cannot be made.
+             */
+            bool load(const std::string& svgPath, int size, int pixels, const std::string& cacheDirectory = defaultCacheDirectory()) {
+                delete m_image;
+                m_image = nullptr;
+                MappedFile svg;
+                if (size <= 0 || pixels <= 0 || !svg.open(svgPath)) return false;
+                uint64_t hash = fnv1a(svg.data(), svg.size(), 14695981039346656037ULL ^ VERSION);
+                std::string path = cacheDirectory + "/atlas-" + std::to_string(pixels) + "-" + hex(hash) + ".rgba";
+
+                if (!map(path, hash, pixels)) {
+                    std::vector<unsigned char> pixelData;
+                    std::string text(reinterpret_cast<const char*>(svg.data()), svg.size());
+                    if (!rasterize(text, pixels, pixelData)) return false;
+                    if (!write(path, hash, pixels, pixelData) || !map(path, hash, pixels)) {
+                        // no cache this time, draw from memory
+                        m_memory.swap(pixelData);
+                        m_image = new Fl_RGB_Image(m_memory.data(), COLUMNS * pixels, ROWS * pixels, 4);
+                    }
+                }
+                m_size = size;
+#if FL_API_VERSION >= 10400
+                m_image->scale(COLUMNS * size, ROWS * size, 0, 1);
+#endif
+                return true;
+            }
+
+            bool loaded() const { return m_image != nullptr; }
+            int size() const { return m_size; }
+
+            /**
+             * @brief Draw a piece with its upper left corner at (x, y)
+             */
+            void draw(int piece, int x, int y) const {
+                m_image->draw(x, y, m_size, m_size, column(Piece::PieceType(piece)) * m_size, Piece::ColorIndex(Piece::Color(piece)) * m_size);
+            }
+
+            /**
+             * @brief $XDG_CACHE_HOME/chess, or ~/.cache/chess
+             */
+            static std::string defaultCacheDirectory() {
+                const char* xdg = std::getenv("XDG_CACHE_HOME");
+                const char* home = std::getenv("HOME");
+                std::string base = xdg && *xdg ? xdg : home && *home ? std::string(home) + "/.cache" : "/tmp";
+                return base + "/chess";
+            }
+
+        private:
+            // Fixed layout at the start of the cache file, the pixels follow
+            struct Header {
+                char magic[8];              // "KSATLAS\0"
+                uint32_t version;
+                uint32_t pixels;            // cell size
+                uint64_t assetHash;
+                uint32_t width;
+                uint32_t height;
+            };
+
+            // A piece's cell in the SVG, in SVG user units
+            struct Cell {
+                double x = 0, y = 0, w = 0, h = 0;
+                bool found = false;
+            };
+
+            static int column(int type) {
+                switch (type) {
+                    case Piece::KING: return 0;
+                    case Piece::QUEEN: return 1;
+                    case Piece::ROOK: return 2;
+                    case Piece::BISHOP: return 3;
+                    case Piece::KNIGHT: return 4;
+                    default: return 5;
+                }
+            }
+
+            static uint64_t fnv1a(const unsigned char* data, size_t size, uint64_t hash) {
+                for (size_t i = 0; i < size; ++i) hash = (hash ^ data[i]) * 1099511628211ULL;
+                return hash;
+            }
+
+            static std::string hex(uint64_t value) {
+                static const char digits[] = "0123456789abcdef";
+                std::string s(16, '0');
+                for (int i = 15; i >= 0; --i, value >>= 4) s[i] = digits[value & 15];
+                return s;
+            }
+
+            bool map(const std::string& path, uint64_t hash, int pixels) {
+                if (!m_file.open(path) || m_file.size() < sizeof(Header)) return false;
+                Header h;
+                std::memcpy(&h, m_file.data(), sizeof(h));
+                size_t bytes = static_cast<size_t>(h.width) * h.height * 4;
+                if (std::memcmp(h.magic, "KSATLAS", 8) != 0 || h.version != VERSION || h.assetHash != hash ||
+                    h.pixels != static_cast<uint32_t>(pixels) || h.width != static_cast<uint32_t>(COLUMNS * pixels) ||
+                    h.height != static_cast<uint32_t>(ROWS * pixels) || m_file.size() != sizeof(Header) + bytes) {
+                    m_file.close();
+                    return false;
+                }
+                m_image = new Fl_RGB_Image(m_file.data() + sizeof(Header), h.width, h.height, 4);
+                return true;
+            }
+
+            static bool write(const std::string& path, uint64_t hash, int pixels, const std::vector<unsigned char>& data) {
+                std::string directory = path.substr(0, path.rfind('/'));
+                for (size_t slash = directory.find('/', 1); ; slash = directory.find('/', slash + 1)) {
+                    std::string part = directory.substr(0, slash);
+                    if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) return false;
+                    if (slash == std::string::npos) break;
+                }
+                Header h;
+                std::memcpy(h.magic, "KSATLAS", 8);
+                h.version = VERSION;
+                h.pixels = pixels;
+                h.assetHash = hash;
+                h.width = COLUMNS * pixels;
+                h.height = ROWS * pixels;
+
+                // written aside and renamed, so another instance never maps half a file
+                std::string temp = path + "." + std::to_string(getpid()) + ".tmp";
+                {
+                    std::ofstream out(temp, std::ios::binary);
+                    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+                    if (!out) {
+                        std::remove(temp.c_str());
+                        return false;
+                    }
+                }
+                return std::rename(temp.c_str(), path.c_str()) == 0;
+            }
+
+            // The export rectangles of the asset name their piece: inkscape:export-filename="Pawn_BLACK.png"
+            static bool findCells(const std::string& svg, Cell cells[2][8]) {
+                static const char* const names[8] = {nullptr, "King", "Pawn", "Knight", nullptr, "Bishop", "Rook", "Queen"};
+                for (size_t at = svg.find("<rect"); at != std::string::npos; at = svg.find("<rect", at + 5)) {
+                    std::string tag = svg.substr(at, svg.find('>', at) - at);
+                    std::string file = attribute(tag, "inkscape:export-filename");
+                    for (int type = 0; type < 8; ++type) {
+                        if (!names[type] || file.compare(0, std::strlen(names[type]) + 1, std::string(names[type]) + "_") != 0) continue;
+                        Cell& cell = cells[file.find("_BLACK") != std::string::npos ? 1 : 0][type];
+                        cell.x = std::atof(attribute(tag, "x").c_str());
+                        cell.y = std::atof(attribute(tag, "y").c_str());
+                        cell.w = std::atof(attribute(tag, "width").c_str());
+                        cell.h = std::atof(attribute(tag, "height").c_str());
+                        cell.found = cell.w > 0 && cell.h > 0;
+                    }
+                }
+                for (int c = 0; c < 2; ++c)
+                    for (int type : {Piece::KING, Piece::PAWN, Piece::KNIGHT, Piece::BISHOP, Piece::ROOK, Piece::QUEEN})
+                        if (!cells[c][type].found) return false;
+                return true;
+            }
+
+            // Position of an attribute's value in a tag, or npos
+            static size_t valueAt(const std::string& tag, const std::string& name) {
+                std::string key = name + "=\"";
+                for (size_t at = tag.find(key); at != std::string::npos; at = tag.find(key, at + 1)) {
+                    if (at > 0 && std::isspace(static_cast<unsigned char>(tag[at - 1]))) return at + key.size();
+                }
+                return std::string::npos;
+            }
+
+            static std::string attribute(const std::string& tag, const std::string& name) {
+                size_t at = valueAt(tag, name);
+                return at == std::string::npos ? "" : tag.substr(at, tag.find('"', at) - at);
+            }
+
+            static void setAttribute(std::string& svg, size_t tagStart, size_t tagEnd, const std::string& name, const std::string& value) {
+                std::string tag = svg.substr(tagStart, tagEnd - tagStart);
+                size_t at = valueAt(tag, name);
+                if (at == std::string::npos) svg.insert(tagStart + 4, " " + name + "=\"" + value + "\"");
+                else svg.replace(tagStart + at, tag.find('"', at) - at, value);
+            }
+
+            // Render every cell by pointing the document's viewBox at it
+            bool rasterize(const std::string& svg, int pixels, std::vector<unsigned char>& atlas) const {
+#if FL_API_VERSION >= 10400
+                Cell cells[2][8];
+                if (!findCells(svg, cells)) return false;
+                int stride = COLUMNS * pixels * 4;
+                atlas.assign(static_cast<size_t>(stride) * ROWS * pixels, 0);
+                for (int c = 0; c < 2; ++c) {
+                    for (int type : {Piece::KING, Piece::PAWN, Piece::KNIGHT, Piece::BISHOP, Piece::ROOK, Piece::QUEEN}) {
+                        const Cell& cell = cells[c][type];
+                        std::string doc = svg;
+                        size_t start = doc.find("<svg");
+                        if (start == std::string::npos) return false;
+                        std::string box = std::to_string(cell.x) + " " + std::to_string(cell.y) + " " + std::to_string(cell.w) + " " + std::to_string(cell.h);
+                        setAttribute(doc, start, doc.find('>', start), "viewBox", box);
+                        setAttribute(doc, start, doc.find('>', start), "width", std::to_string(pixels));
+                        setAttribute(doc, start, doc.find('>', start), "height", std::to_string(pixels));
+
+                        Fl_SVG_Image image(nullptr, doc.c_str());
+                        if (image.fail()) return false;
+                        image.resize(pixels, pixels);
+                        image.normalize();
+                        if (image.d() != 4 || image.data_w() != pixels || image.data_h() != pixels) return false;
+                        int rowBytes = image.ld() ? image.ld() : pixels * 4;
+                        const unsigned char* src = image.array;
+                        unsigned char* dst = atlas.data() + static_cast<size_t>(c) * pixels * stride + column(type) * pixels * 4;
+                        for (int y = 0; y < pixels; ++y) std::memcpy(dst + static_cast<size_t>(y) * stride, src + static_cast<size_t>(y) * rowBytes, pixels * 4);
+                    }
+                }
+                return true;
+#else
+                (void)svg;
+                (void)pixels;
+                (void)atlas;
+                return false;
+#endif
+            }
+
+            Fl_RGB_Image* m_image; //!the atlas, over the mapping or m_memory
+            MappedFile m_file; //!the cache file
+            std::vector<unsigned char> m_memory; //!the pixels when the cache could not be written
+            int m_size; //!cell size in FLTK units
+    };
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef POINT_HH__
 #define POINT_HH__
 
+#include <cmath>
 #include <iostream>
 
 namespace AUGL {
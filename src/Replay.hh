@@ -0,0 +1,172 @@
+#ifndef REPLAY_HH__
+#define REPLAY_HH__
+
+#include "Board.hh"
+#include "Move.hh"
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief The moves of a game and a cursor that can show the position after any ply
+     *
+     * A full Board is kept every INTERVAL plies (ply 0 is the start position). Seeking
+     * copies the nearest snapshot at or before the ply and plays the few moves after it,
+     * or, when the cursor is already in the same stretch, makes or unmakes the moves in
+     * between. Either way a seek costs at most one Board copy and INTERVAL - 1 moves,
+     * whatever the length of the game, so a scrubber can be dragged across hundreds of
+     * plies. Snapshots carry the repetition history, so the positions are exact.
+     *
+     * A game restored from a save file starts with only the start position; the other
+     * snapshots are made the first time a seek needs them, so restoring is instant.
+     * Restored moves are not trusted: each is checked against the moves of its piece the
+     * first time it is played, and the game is cut before the first one that is not legal.
+     */
+    class Replay{
+        public:
+            static const int INTERVAL = 16;
+
+            explicit Replay(const Board& start = Board()) { reset(start); }
+
+            /**
+             * @brief Start over from a position with no moves
+             */
+            void reset(const Board& start) {
+                m_moves.clear();
+                m_snapshots.assign(1, start);
+                m_board = start;
+                m_ply = 0;
+                m_undo.clear();
+                m_undo.reserve(INTERVAL);
+                m_restored = m_checked = 0;
+            }
+
+            /**
+             * @brief Take over a game without replaying it: its moves from start should lead to
+             *        end, the cursor is put on end. The moves are checked as seeks play them.
+             */
+            void restore(const Board& start, const std::vector<Move>& moves, const Board& end) {
+                reset(start);
+                m_moves = moves;
+                m_board = end;
+                m_ply = plies();
+                m_restored = plies();
+            }
+
+            /**
+             * @brief Append a move played after the last ply, the cursor stays where it is
+             */
+            void push(const Move& move) {
+                m_moves.push_back(move);
+                // snapshots missing after a restore stay missing until a seek needs them
+                int index = plies() / INTERVAL;
+                if (plies() % INTERVAL == 0 && static_cast<int>(m_snapshots.size()) == index) snapshot(index);
+            }
+
+            /**
+             * @brief Keep only the first count plies, to play a different continuation
+             */
+            void truncate(int count) {
+                if (count >= plies()) return;
+                if (m_ply > count) seek(count);
+                m_moves.resize(count);
+                if (m_restored > count) m_restored = count;
+                if (static_cast<int>(m_snapshots.size()) > count / INTERVAL + 1) m_snapshots.resize(count / INTERVAL + 1);
+            }
+
+            /**
+             * @brief Move the cursor to the position after a ply, 0 is the start position.
+             *        A restored move found illegal on the way cuts the game and the cursor stops there.
+             */
+            const Board& seek(int ply) {
+                if (ply < 0) ply = 0;
+                if (ply > plies()) ply = plies();
+                int base = m_ply - static_cast<int>(m_undo.size());
+                if (ply < base || ply >= base + INTERVAL) {
+                    int index = snapshot(ply / INTERVAL);
+                    m_board = m_snapshots[index];
+                    m_ply = index * INTERVAL;
+                    m_undo.clear();
+                }
+                while (m_ply > ply) {
+                    m_board.unmakeMove(m_moves[m_ply - 1], m_undo.back());
+                    m_undo.pop_back();
+                    --m_ply;
+                }
+                while (m_ply < ply && m_ply < plies()) {
+                    m_undo.emplace_back();
+                    if (!play(m_board, m_ply, m_undo.back())) {
+                        m_undo.pop_back();
+                        break;
+                    }
+                    ++m_ply;
+                }
+                return m_board;
+            }
+
+            const Board& board() const { return m_board; }
+            int ply() const { return m_ply; }
+            int plies() const { return static_cast<int>(m_moves.size()); }
+            const Move& move(int ply) const { return m_moves[ply]; }
+            const std::vector<Move>& moves() const { return m_moves; }
+            const Board& start() const { return m_snapshots.front(); }
+
+        private:
+            // Make the snapshots up to the position after ply index * INTERVAL from the ones before
+            // it and return index, or the last one there is if the game was cut on the way; the
+            // cursor is not disturbed
+            int snapshot(int index) {
+                while (static_cast<int>(m_snapshots.size()) <= index) {
+                    Board board = m_snapshots.back();
+                    Board::Undo u;
+                    int first = (static_cast<int>(m_snapshots.size()) - 1) * INTERVAL;
+                    for (int ply = first; ply < first + INTERVAL; ++ply)
+                        if (!play(board, ply, u)) return static_cast<int>(m_snapshots.size()) - 1;
+                    m_snapshots.push_back(board);
+                }
+                return index;
+            }
+
+            // Make the move of a ply on the position before it. A restored move is checked the first
+            // time; if it is not legal there the game ends before it and false is returned.
+            bool play(Board& board, int ply, Board::Undo& u) {
+                const Move& move = m_moves[ply];
+                if (ply == m_checked && ply < m_restored) {
+                    MoveList moves;
+                    if (Piece::isColor(board.pieceAt(move.from()), board.sideToMove())) board.addPieceMoves(move.from(), false, moves);
+                    bool legal = false;
+                    for (const Move& m : moves) legal = legal || (m.raw() == move.raw() && board.isLegal(m));
+                    if (!legal) {
+                        cut(ply);
+                        return false;
+                    }
+                    ++m_checked;
+                }
+                board.makeMove(move, u);
+                return true;
+            }
+
+            // Drop a restored game's moves from the first bad one on, and the cursor back if it was past it
+            void cut(int ply) {
+                m_moves.resize(ply);
+                m_restored = ply;
+                if (static_cast<int>(m_snapshots.size()) > ply / INTERVAL + 1) m_snapshots.resize(ply / INTERVAL + 1);
+                if (m_ply > ply) {
+                    m_board = m_snapshots.back();
+                    m_ply = (static_cast<int>(m_snapshots.size()) - 1) * INTERVAL;
+                    m_undo.clear();
+                }
+            }
+
+            std::vector<Move> m_moves; //!every ply of the game
+            std::vector<Board> m_snapshots; //!the position after ply 0, INTERVAL, 2 * INTERVAL, ...
+            Board m_board; //!position at the cursor
+            int m_ply; //!plies played to reach m_board
+            std::vector<Board::Undo> m_undo; //!moves made on m_board since its snapshot
+            int m_restored; //!plies taken over by restore(), checked as they are first played
+            int m_checked; //!plies from the start found legal so far
+    };
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef RINGBUFFER_HH__
+#define RINGBUFFER_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Bounded lock-free queue for one producer thread and one consumer thread
+     *
+     * The items live in a fixed array; the two threads only share the head and tail
+     * counters, each on its own cache line, and each side keeps a copy of the other's
+     * counter so it reads the shared one only when the copy says the queue looks full
+     * or empty. push() fails when the queue is full instead of waiting.
+     */
+    template <typename T, size_t CAPACITY>
+    class SpscRing{
+        static_assert(CAPACITY && (CAPACITY & (CAPACITY - 1)) == 0, "the capacity must be a power of two");
+
+        public:
+            SpscRing() : m_head(0), m_tailCopy(0), m_tail(0), m_headCopy(0) {}
+
+            SpscRing(const SpscRing&) = delete;
+            SpscRing& operator=(const SpscRing&) = delete;
+
+            // Producer side
+            bool push(const T& item) {
+                size_t tail = m_tail.load(std::memory_order_relaxed);
+                if (tail - m_headCopy == CAPACITY) {
+                    m_headCopy = m_head.load(std::memory_order_acquire);
+                    if (tail - m_headCopy == CAPACITY) return false;
+                }
+                m_items[tail & (CAPACITY - 1)] = item;
+                m_tail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Consumer side
+            bool pop(T& item) {
+                size_t head = m_head.load(std::memory_order_relaxed);
+                if (head == m_tailCopy) {
+                    m_tailCopy = m_tail.load(std::memory_order_acquire);
+                    if (head == m_tailCopy) return false;
+                }
+                item = m_items[head & (CAPACITY - 1)];
+                m_head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+        private:
+            alignas(64) std::atomic<size_t> m_head; //!next item to pop, written by the consumer
+            size_t m_tailCopy; //!the consumer's last look at m_tail
+            alignas(64) std::atomic<size_t> m_tail; //!next free item, written by the producer
+            size_t m_headCopy; //!the producer's last look at m_head
+            alignas(64) T m_items[CAPACITY]; //!the ring
+    };
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Bounded lock-free queue for any number of producer threads and one consumer
+     *
+     * Every cell carries a sequence number that says whose turn it is: producers claim
+     * a cell by advancing the shared tail with a compare-and-swap and publish it by
+     * bumping its sequence, and the consumer takes cells in order as they are
+     * published. Producers never wait for each other's writes to finish, and the
+     * consumer never writes what producers read except the cell it hands back.
+     * push() fails when the queue is full instead of waiting.
+     */
+    template <typename T, size_t CAPACITY>
+    class MpscRing{
+        static_assert(CAPACITY && (CAPACITY & (CAPACITY - 1)) == 0, "the capacity must be a power of two");
+
+        public:
+            MpscRing() : m_tail(0), m_head(0) {
+                for (size_t i = 0; i < CAPACITY; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            MpscRing(const MpscRing&) = delete;
+            MpscRing& operator=(const MpscRing&) = delete;
+
+            // Any thread
+            bool push(const T& item) {
+                size_t tail = m_tail.load(std::memory_order_relaxed);
+                Cell* cell;
+                for (;;) {
+                    cell = &m_cells[tail & (CAPACITY - 1)];
+                    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(tail);
+                    if (lag == 0 && m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) break;
+                    if (lag < 0) return false;  // the consumer has not freed this cell yet
+                    if (lag > 0) tail = m_tail.load(std::memory_order_relaxed);
+                }
+                cell->item = item;
+                cell->sequence.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Consumer side
+            bool pop(T& item) {
+                Cell& cell = m_cells[m_head & (CAPACITY - 1)];
+                if (cell.sequence.load(std::memory_order_acquire) != m_head + 1) return false;
+                item = cell.item;
+                cell.sequence.store(m_head + CAPACITY, std::memory_order_release);
+                ++m_head;
+                return true;
+            }
+
+            // Consumer side: nothing published yet
+            bool empty() const {
+                return m_cells[m_head & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) != m_head + 1;
+            }
+
+        private:
+            struct Cell {
+                std::atomic<size_t> sequence;  // tail value it can be claimed at, or that + 1 once published
+                T item;
+            };
+
+            alignas(64) std::atomic<size_t> m_tail; //!next cell to claim, shared by the producers
+            alignas(64) size_t m_head; //!next cell to pop, the consumer's own
+            alignas(64) Cell m_cells[CAPACITY]; //!the ring
+    };
+}
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef SAVEDGAME_HH__
+#define SAVEDGAME_HH__
+
+#include "Board.hh"
+#include "GameClock.hh"
+#include "MappedFile.hh"
+#include "Move.hh"
+#include "Replay.hh"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief A game in progress saved to one binary file, so the app can reopen on it at once
+     *
+     * The file is a fixed-layout Header followed by the arrays it counts:
+     *
+     *   Header                    magic, version, counts, a checksum of the file, the start
+     *                             and current position (Board::Packed), the clocks and the settings
+     *   uint32_t sanStarts[n + 1] offsets of each move's SAN in the text below
+     *   uint16_t moves[n]         the moves as Move::raw()
+     *   char san[]                the SAN of all moves back to back
+     *
+     * Loading maps the file, checks the header against the file size and copies it out;
+     * the arrays are used in place. A file whose checksum (FNV-1a over the whole file
+     * with the checksum field zero) does not match is rejected. The current position is
+     * stored, so resuming does not replay the moves; Replay checks each one the first
+     * time it plays it, when an earlier position is shown. The SAN is stored, so the
+     * move list needs no notation work.
+     * Numbers are in the byte order of the machine that wrote them. A file of another
+     * version or layout is rejected, and the app starts a new game.
+     *
+     * Saving writes a temporary file, syncs it, renames it over the old one and syncs
+     * the directory, so a restart or power cut in the middle of a save leaves the
+     * previous save intact.
+     */
+    class SavedGame{
+        public:
+            static const uint32_t VERSION = 2;
+
+            /**
+             * @brief Both clocks as they were when saved
+             */
+            struct Clocks {
+                int64_t remainingMs[2];     // white, black
+                int64_t incrementMs;
+                uint8_t mode;               // GameClock::Mode
+                int8_t running;             // color index of the clock that was running, -1 if none
+                uint8_t reserved[6];
+            };
+
+            /**
+             * @brief Window settings that belong to the session
+             */
+            struct Settings {
+                int32_t thinkMs = 3000;     // engine time per move
+                uint8_t flipped = 0;        // black at the bottom
+                uint8_t reserved[3] = {};
+            };
+
+            SavedGame() : m_header() {}
+
+            /**
+             * @brief Write a game; position is the position after all of the game's moves and san
+             *        the move list's text with its offsets (may be empty). Returns false on failure.
+             */
+            static bool save(const std::string& path, const Replay& game, const Board& position, const GameClock& clock,
+                             const Settings& settings, const std::string& san = "", const std::vector<uint32_t>& sanStarts = {}) {
+                Header h = {};
+                std::memcpy(h.magic, "KSSAVE", 7);
+                h.version = VERSION;
+                h.headerBytes = sizeof(Header);
+                h.packedBytes = sizeof(Board::Packed);
+                h.plies = static_cast<uint32_t>(game.plies());
+                bool withSan = sanStarts.size() == h.plies + 1u && sanStarts.back() == san.size();
+                h.sanBytes = withSan ? static_cast<uint32_t>(san.size()) : 0;
+                h.start = game.start().pack();
+                h.position = position.pack();
+                for (int c = 0; c < 2; ++c) h.clocks.remainingMs[c] = clock.remainingMs(c == 0 ? Piece::WHITE : Piece::BLACK);
+                h.clocks.incrementMs = clock.incrementMs();
+                h.clocks.mode = static_cast<uint8_t>(clock.mode());
+                h.clocks.running = -1;
+                if (clock.running()) h.clocks.running = static_cast<int8_t>(Piece::ColorIndex(position.sideToMove()));
+                h.settings = settings;
+
+                std::vector<unsigned char> data(fileSize(h));
+                unsigned char* out = data.data();
+                std::memcpy(out, &h, sizeof(h));
+                uint32_t* starts = reinterpret_cast<uint32_t*>(out + sizeof(h));
+                uint16_t* moves = reinterpret_cast<uint16_t*>(starts + h.plies + 1);
+                for (uint32_t i = 0; i <= h.plies; ++i) starts[i] = withSan ? sanStarts[i] : 0;
+                for (uint32_t i = 0; i < h.plies; ++i) moves[i] = game.move(static_cast<int>(i)).raw();
+                if (withSan) std::memcpy(moves + h.plies, san.data(), san.size());
+                h.checksum = checksum(data.data(), data.size());
+                std::memcpy(out, &h, sizeof(h));
+                return write(path, data);
+            }
+
+            /**
+             * @brief Map a save file, false if there is none, it does not fit this version or
+             *        its checksum does not match
+             */
+            bool load(const std::string& path) {
+                m_file.close();
+                if (!m_file.open(path) || m_file.size() < sizeof(Header)) return fail();
+                std::memcpy(&m_header, m_file.data(), sizeof(Header));
+                const Header& h = m_header;
+                if (std::memcmp(h.magic, "KSSAVE", 7) != 0 || h.version != VERSION || h.headerBytes != sizeof(Header) ||
+                    h.packedBytes != sizeof(Board::Packed) || m_file.size() != fileSize(h)) return fail();
+                Header unsummed = h;
+                unsummed.checksum = 0;
+                uint32_t sum = checksum(reinterpret_cast<const unsigned char*>(&unsummed), sizeof(Header));
+                if (checksum(m_file.data() + sizeof(Header), m_file.size() - sizeof(Header), sum) != h.checksum) return fail();
+                const uint32_t* starts = sanStarts();
+                for (uint32_t i = 0; h.sanBytes && i < h.plies; ++i)
+                    if (starts[i] > starts[i + 1]) return fail();
+                if (h.sanBytes && (starts[0] != 0 || starts[h.plies] != h.sanBytes)) return fail();
+                return true;
+            }
+
+            /**
+             * @brief Put the loaded game back, false if the positions do not unpack
+             */
+            bool restore(Replay& game, Board& position, GameClock& clock, Settings& settings) const {
+                if (!m_file.isOpen()) return false;
+                Board start;
+                if (!start.unpack(m_header.start) || !position.unpack(m_header.position)) return false;
+                std::vector<Move> moves(m_header.plies);
+                for (uint32_t i = 0; i < m_header.plies; ++i) moves[i] = Move::fromRaw(raw()[i]);
+                game.restore(start, moves, position);
+                const Clocks& c = m_header.clocks;
+                clock.restore(c.remainingMs[0], c.remainingMs[1], c.incrementMs, c.mode == GameClock::BRONSTEIN ? GameClock::BRONSTEIN : GameClock::FISCHER);
+                settings = m_header.settings;
+                return true;
+            }
+
+            bool loaded() const { return m_file.isOpen(); }
+            int plies() const { return static_cast<int>(m_header.plies); }
+            const Clocks& clocks() const { return m_header.clocks; }
+
+            // The SAN text of the moves and its offsets, in the mapping; null when the save has none
+            const char* san() const { return m_header.sanBytes ? reinterpret_cast<const char*>(raw() + m_header.plies) : nullptr; }
+            const uint32_t* sanStarts() const { return reinterpret_cast<const uint32_t*>(m_file.data() + sizeof(Header)); }
+
+            /**
+             * @brief $XDG_STATE_HOME/chess/session.ksav, or ~/.local/state/chess/session.ksav
+             */
+            static std::string defaultPath() {
+                const char* xdg = std::getenv("XDG_STATE_HOME");
+                const char* home = std::getenv("HOME");
+                std::string base = xdg && *xdg ? xdg : home && *home ? std::string(home) + "/.local/state" : "/tmp";
+                return base + "/chess/session.ksav";
+            }
+
+        private:
+            // Fixed layout at the start of the file, the arrays follow
+            struct Header {
+                char magic[8];              // "KSSAVE\0\0"
+                uint32_t version;
+                uint32_t headerBytes;       // sizeof(Header)
+                uint32_t packedBytes;       // sizeof(Board::Packed)
+                uint32_t plies;             // moves in the game
+                uint32_t sanBytes;          // length of the SAN text, 0 if not saved
+                uint32_t checksum;          // FNV-1a of the file with this field zero
+                Board::Packed start;        // position before the first move
+                Board::Packed position;     // position after the last move
+                Clocks clocks;
+                Settings settings;
+            };
+            static_assert(std::is_trivially_copyable<Header>::value, "the header is copied as bytes");
+            static_assert(sizeof(Header) % alignof(uint32_t) == 0, "the offsets after the header must be aligned");
+
+            static size_t fileSize(const Header& h) {
+                return sizeof(Header) + (h.plies + 1u) * sizeof(uint32_t) + h.plies * sizeof(uint16_t) + h.sanBytes;
+            }
+
+            // FNV-1a, continuing from sum so the file can be summed in pieces
+            static uint32_t checksum(const unsigned char* data, size_t size, uint32_t sum = 2166136261u) {
+                for (size_t i = 0; i < size; ++i) sum = (sum ^ data[i]) * 16777619u;
+                return sum;
+            }
+
+            const uint16_t* raw() const { return reinterpret_cast<const uint16_t*>(sanStarts() + m_header.plies + 1); }
+
+            bool fail() {
+                m_file.close();
+                m_header = Header();
+                return false;
+            }
+
+            static bool write(const std::string& path, const std::vector<unsigned char>& data) {
+                std::string directory = path.substr(0, path.rfind('/'));
+                for (size_t slash = directory.find('/', 1); ; slash = directory.find('/', slash + 1)) {
+                    std::string part = directory.substr(0, slash);
+                    if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) return false;
+                    if (slash == std::string::npos) break;
+                }
+                std::string temp = path + "." + std::to_string(getpid()) + ".tmp";
+                int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0) return false;
+                bool written = ::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+                // the data must be on disk before the rename is, or a power cut can leave a short file
+                written = ::fsync(fd) == 0 && written;
+                written = ::close(fd) == 0 && written;
+                if (!written || std::rename(temp.c_str(), path.c_str()) != 0) {
+                    std::remove(temp.c_str());
+                    return false;
+                }
+                // and the rename itself lives in the directory
+                int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+                if (dir >= 0) {
+                    ::fsync(dir);
+                    ::close(dir);
+                }
+                return true;
+            }
+
+            MappedFile m_file; //!the save file
+            Header m_header; //!copy of the file's header
+    };
+}
+
+#endif
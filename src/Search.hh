@@ -0,0 +1,568 @@
+#ifndef SEARCH_HH__
+#define SEARCH_HH__
+
+#include "Board.hh"
+#include "Evaluation.hh"
+#include "SearchStats.hh"
+#include "TimeManager.hh"
+#include "TranspositionTable.hh"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @brief Tunable search constants, so two configurations can play each other
+     */
+    struct SearchParams {
+        int futilityMargin = 80;     // reverse futility pruning margin per ply of depth
+        int futilityDepth = 6;       // deepest node reverse futility pruning applies to
+        int nullMoveDepth = 3;       // shallowest node null move pruning applies to
+        int nullMoveReduction = 3;   // base depth reduction of the null move search
+        int lmrBase = 75;            // late move reduction = lmrBase / 100 + ln(depth) * ln(moveNumber) * 100 / lmrDivisor
+        int lmrDivisor = 225;
+        int lmrMinMoves = 3;         // moves searched at full depth before reducing
+
+        /**
+         * @brief Set a parameter by its name, returns false if there is no such parameter
+         */
+        bool set(const std::string& name, int value) {
+            if (name == "futilityMargin") futilityMargin = value;
+            else if (name == "futilityDepth") futilityDepth = value;
+            else if (name == "nullMoveDepth") nullMoveDepth = value;
+            else if (name == "nullMoveReduction") nullMoveReduction = value;
+            else if (name == "lmrBase") lmrBase = value;
+            else if (name == "lmrDivisor") lmrDivisor = value > 0 ? value : 1;
+            else if (name == "lmrMinMoves") lmrMinMoves = value;
+            else return false;
+            return true;
+        }
+    };
+
+    /**
+     * @brief Progress report of a completed iteration
+     */
+    struct SearchInfo {
+        int depth = 0;
+        int seldepth = 0;
+        int score = 0;              // centipawns from the side to move, or a mate score
+        uint64_t nodes = 0;
+        int64_t timeMs = 0;
+        int hashfull = 0;
+        int multipv = 1;            // rank of the line in MultiPV mode, 1 for the best
+        std::vector<Move> pv;
+    };
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Iterative deepening alpha-beta search
+     *
+     * Principal variation search with a transposition table, null move pruning,
+     * late move reductions and a capture-only quiescence search. With more than one
+     * thread the helpers search the same position and share results through the
+     * transposition table; only the main thread reports and picks the move.
+     *
+     * In MultiPV mode the main thread searches the root once per line, each time
+     * leaving out the root moves of the lines found before, so the lines come out best
+     * first. The later lines profit from the hash table entries of the earlier ones.
+     */
+    class Search{
+        public:
+            static const int MAX_PLY = 128;
+            static const int MATE = 32000;
+            static const int MATE_BOUND = MATE - MAX_PLY;   // scores beyond this are mates
+            static const int INFINITE_SCORE = MATE + 1;
+            static const int MAX_MULTIPV = 64;
+
+            typedef std::function<void(const SearchInfo&)> InfoCallback;
+
+            explicit Search(TranspositionTable& tt) : m_tt(tt), m_threads(1), m_stop(false), m_pondering(false), m_prepared(false) {}
+
+            void setThreads(int threads) { m_threads = threads < 1 ? 1 : threads; }
+            int threads() const { return m_threads; }
+
+            /**
+             * @brief Number of best lines to find and report, change only between searches
+             */
+            void setMultiPV(int lines) { m_multiPV = lines < 1 ? 1 : lines > MAX_MULTIPV ? MAX_MULTIPV : lines; }
+            int multiPV() const { return m_multiPV; }
+
+            /**
+             * @brief The pruning and reduction constants, change only between searches
+             */
+            SearchParams& params() { return m_params; }
+
+            /**
+             * @brief Search the position within the limits and return the best move
+             *
+             * onInfo is called from the calling thread after every completed iteration.
+             */
+            Move think(const Board& root, const SearchLimits& limits, InfoCallback onInfo = nullptr) {
+                m_limits = limits;
+                m_onInfo = onInfo;
+                if (!m_prepared.exchange(false)) prepare(limits.ponder);
+                m_time.start(limits, root.sideToMove());
+                m_result = SearchInfo();
+                m_lines.clear();
+                m_tt.newSearch();
+
+                m_workers.clear();
+                for (int i = 0; i < m_threads; ++i) {
+                    m_workers.emplace_back(new Worker());
+                    m_workers.back()->id = i;
+                    m_workers.back()->board = root;
+                }
+
+                std::vector<std::thread> helpers;
+                for (int i = 1; i < m_threads; ++i) helpers.emplace_back([this, i]() { iterativeDeepening(*m_workers[i]); });
+                iterativeDeepening(*m_workers[0]);
+
+                // in infinite and ponder mode the best move may only be sent after stop or ponderhit
+                while (!m_stop && (m_limits.infinite || m_pondering)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                m_stop = true;
+                for (auto& t : helpers) t.join();
+
+                m_result.nodes = nodes();
+                m_result.timeMs = elapsedMs();
+                return m_result.pv.empty() ? Move() : m_result.pv[0];
+            }
+
+            /**
+             * @brief Abort the running search as soon as possible, safe to call from any thread
+             */
+            void stop() { m_stop = true; }
+
+            /**
+             * @brief Clear the stop and ponder flags for the next think()
+             *
+             * think() does this itself. A caller that runs think() on another thread calls it
+             * first, so a stop() or ponderhit() sent right after is not lost.
+             */
+            void prepare(bool ponder) {
+                m_stop = false;
+                m_pondering = ponder;
+                m_prepared = true;
+            }
+
+            /**
+             * @brief The opponent played the expected move: keep searching, now under the time limits
+             */
+            void ponderhit() {
+                m_time.restart();
+                m_pondering = false;
+            }
+
+            /**
+             * @brief The last completed iteration of the last search
+             */
+            const SearchInfo& result() const { return m_result; }
+
+            /**
+             * @brief Every line of the last completed iteration, best first (one unless MultiPV is set)
+             */
+            const std::vector<SearchInfo>& lines() const { return m_lines; }
+
+            /**
+             * @brief The reply the search expects after its best move, null if unknown
+             */
+            Move ponderMove() const { return m_result.pv.size() > 1 ? m_result.pv[1] : Move(); }
+
+            /**
+             * @brief Nodes searched so far by all threads
+             */
+            uint64_t nodes() const {
+                uint64_t n = 0;
+                for (const auto& w : m_workers) n += w->nodes.load(std::memory_order_relaxed);
+                return n;
+            }
+
+            /**
+             * @brief Counters of the last search added up over all threads, all zero when
+             *        the statistics are compiled out (SearchStats::ENABLED)
+             */
+            SearchStats stats() const {
+                SearchStats total;
+#if KS_SEARCH_STATS
+                for (const auto& w : m_workers) total.add(w->stats);
+                if (!m_workers.empty()) {
+                    total.iterationNodes[0] = m_workers[0]->stats.iterationNodes[0];
+                    total.iterationNodes[1] = m_workers[0]->stats.iterationNodes[1];
+                }
+#endif
+                total.nodes = nodes();
+                return total;
+            }
+
+            static bool isMateScore(int score) { return score > MATE_BOUND || score < -MATE_BOUND; }
+
+            /**
+             * @brief Moves until mate for a mate score, negative when the side to move is mated
+             */
+            static int mateInMoves(int score) {
+                int plies = MATE - (score > 0 ? score : -score);
+                return score > 0 ? (plies + 1) / 2 : -plies / 2;
+            }
+
+        private:
+            struct Worker {
+                int id = 0;
+                Board board;
+                std::atomic<uint64_t> nodes{0};
+                int seldepth = 0;
+                int completedDepth = 0;
+                Move killers[MAX_PLY + 1][2];
+                int history[2][64][64] = {};
+                Move pv[MAX_PLY + 1][MAX_PLY + 1];
+                int pvLength[MAX_PLY + 1] = {};
+                Move excluded[MAX_MULTIPV];   // root moves of the lines already found this iteration
+                int excludedCount = 0;
+#if KS_SEARCH_STATS
+                SearchStats stats;
+#endif
+            };
+
+            int64_t elapsedMs() const { return m_time.elapsedMs(); }
+
+            // Called by the main thread every few thousand nodes
+            void checkLimits(Worker& w) {
+                if (w.id != 0 || w.completedDepth == 0) return;
+                if (m_limits.nodes && nodes() >= m_limits.nodes) m_stop = true;
+                if (!m_pondering && m_time.hardExpired()) m_stop = true;
+            }
+
+            bool stopped(const Worker& w) const {
+                return w.completedDepth > 0 && m_stop.load(std::memory_order_relaxed);
+            }
+
+            void iterativeDeepening(Worker& w) {
+                KS_STAT_TIMER(w, SEARCH);
+                int maxDepth = m_limits.depth > 0 && m_limits.depth < MAX_PLY ? m_limits.depth : MAX_PLY - 1;
+                int lineCount = 1;
+                if (w.id == 0 && m_multiPV > 1) {
+                    MoveList rootMoves;
+                    w.board.generateLegalMoves(rootMoves);
+                    lineCount = rootMoves.size() < m_multiPV ? (rootMoves.size() > 0 ? rootMoves.size() : 1) : m_multiPV;
+                }
+                std::vector<SearchInfo> lines(lineCount);
+
+                for (int depth = 1 + (w.id & 1); depth <= maxDepth; ++depth) {
+                    w.excludedCount = 0;
+                    for (int line = 0; line < lineCount; ++line) {
+                        w.seldepth = 0;
+                        int score = negamax(w, depth, -INFINITE_SCORE, INFINITE_SCORE, 0, true, false);
+                        if (stopped(w)) break;
+                        SearchInfo& info = lines[line];
+                        info.depth = depth;
+                        info.seldepth = w.seldepth;
+                        info.score = score;
+                        info.multipv = line + 1;
+                        info.pv.assign(w.pv[0], w.pv[0] + w.pvLength[0]);
+                        if (w.pvLength[0] > 0) w.excluded[w.excludedCount++] = w.pv[0][0];
+                    }
+                    if (stopped(w)) break;
+                    w.completedDepth = depth;
+                    if (w.id != 0) continue;
+
+                    int64_t time = elapsedMs();
+                    for (SearchInfo& info : lines) {
+                        info.nodes = nodes();
+                        info.timeMs = time;
+                        info.hashfull = m_tt.hashfull();
+                    }
+                    m_lines = lines;
+                    m_result = lines[0];
+                    int score = m_result.score;
+#if KS_SEARCH_STATS
+                    w.stats.iterationNodes[0] = w.stats.iterationNodes[1];
+                    w.stats.iterationNodes[1] = m_result.nodes;
+#endif
+                    if (m_onInfo) for (const SearchInfo& info : lines) m_onInfo(info);
+
+                    if (!m_result.pv.empty()) m_time.update(m_result.pv[0], score);
+                    if (!m_pondering && m_time.softExpired()) break;
+                    if (m_limits.nodes && nodes() >= m_limits.nodes) break;
+                }
+                if (w.id == 0 && !m_limits.infinite && !m_pondering) m_stop = true;
+            }
+
+            // Mate scores are stored relative to the node so they stay valid at other plies
+            static int scoreToTT(int score, int ply) {
+                return score > MATE_BOUND ? score + ply : score < -MATE_BOUND ? score - ply : score;
+            }
+
+            static int scoreFromTT(int score, int ply) {
+                return score > MATE_BOUND ? score - ply : score < -MATE_BOUND ? score + ply : score;
+            }
+
+            static bool hasNonPawnMaterial(const Board& b, int color) {
+                return b.pieces(color) & ~b.pieces(color, Piece::PAWN) & ~b.pieces(color, Piece::KING);
+            }
+
+            // Order: hash move, captures by most valuable victim / least valuable attacker, killers, history
+            void scoreMoves(const Worker& w, const MoveList& list, int* scores, Move ttMove, int ply) const {
+                static const int value[8] = {0, 0, 1, 3, 0, 3, 5, 9};
+                const Board& b = w.board;
+                int us = Piece::ColorIndex(b.sideToMove());
+                for (int i = 0; i < list.size(); ++i) {
+                    Move m = list[i];
+                    if (m == ttMove) scores[i] = 1 << 30;
+                    else if (m.isCapture()) {
+                        int victim = m.flags() == Move::EN_PASSANT ? Piece::PAWN : Piece::PieceType(b.pieceAt(m.to()));
+                        scores[i] = (1 << 28) + value[victim] * 16 - value[Piece::PieceType(b.pieceAt(m.from()))];
+                    }
+                    else if (m.promotionType() == Piece::QUEEN) scores[i] = (1 << 27);
+                    else if (m == w.killers[ply][0]) scores[i] = (1 << 26) + 1;
+                    else if (m == w.killers[ply][1]) scores[i] = (1 << 26);
+                    else scores[i] = w.history[us][m.from()][m.to()];
+                }
+            }
+
+            // Selection sort step: move the best remaining move to index i
+            static void pickMove(MoveList& list, int* scores, int i) {
+                int best = i;
+                for (int j = i + 1; j < list.size(); ++j)
+                    if (scores[j] > scores[best]) best = j;
+                std::swap(list[i], list[best]);
+                std::swap(scores[i], scores[best]);
+            }
+
+            static bool isExcluded(const Worker& w, const Move& m) {
+                for (int i = 0; i < w.excludedCount; ++i)
+                    if (w.excluded[i] == m) return true;
+                return false;
+            }
+
+            static int evaluate(Worker& w) {
+                KS_STAT_TIMER(w, EVAL);
+                return Evaluation::evaluate(w.board);
+            }
+
+            static void generateMoves(Worker& w, MoveList& list, bool capturesOnly) {
+                KS_STAT_TIMER(w, MOVEGEN);
+                w.board.generatePseudoMoves(list, capturesOnly);
+            }
+
+            // Hash table lookup that returns true when the entry alone decides the node
+            bool probeCutoff(Worker& w, TranspositionTable::Entry& entry, bool& hit, int depth, int alpha, int beta, int ply, int& score) {
+                KS_STAT(w, ttProbes);
+                hit = m_tt.probe(w.board.zobrist(), entry);
+                if (!hit) return false;
+                KS_STAT(w, ttHits);
+                if (entry.depth < depth) return false;
+                score = scoreFromTT(entry.score, ply);
+                if (entry.bound == TranspositionTable::EXACT
+                    || (entry.bound == TranspositionTable::LOWER && score >= beta)
+                    || (entry.bound == TranspositionTable::UPPER && score <= alpha)) {
+                    KS_STAT(w, ttCutoffs);
+                    return true;
+                }
+                return false;
+            }
+
+            void countNode(Worker& w) {
+                uint64_t n = w.nodes.load(std::memory_order_relaxed) + 1;
+                w.nodes.store(n, std::memory_order_relaxed);
+                if ((n & (TimeManager::CHECK_NODES - 1)) == 0) checkLimits(w);
+                if (w.id == 0 && m_limits.nodes && m_threads == 1 && n >= m_limits.nodes && w.completedDepth > 0) m_stop = true;
+            }
+
+            int negamax(Worker& w, int depth, int alpha, int beta, int ply, bool pvNode, bool afterNull) {
+                w.pvLength[ply] = ply;
+                if (depth <= 0) return quiescence(w, alpha, beta, ply);
+
+                Board& b = w.board;
+                countNode(w);
+                if (stopped(w)) return 0;
+                if (ply > w.seldepth) w.seldepth = ply;
+                if (ply >= MAX_PLY - 1) return evaluate(w);
+
+                if (ply > 0) {
+                    if (b.isRepetition(ply) || b.isFiftyMoveDraw() || b.isInsufficientMaterial()) return 0;
+
+                    // mate distance pruning
+                    alpha = alpha > -MATE + ply ? alpha : -MATE + ply;
+                    beta = beta < MATE - ply - 1 ? beta : MATE - ply - 1;
+                    if (alpha >= beta) return alpha;
+                }
+
+                bool inCheck = b.inCheck();
+                TranspositionTable::Entry entry;
+                bool hit;
+                int ttScore;
+                // principal variation nodes never take a hash cutoff, so the depth they ask for is out of reach
+                if (probeCutoff(w, entry, hit, pvNode ? MAX_PLY + 1 : depth, alpha, beta, ply, ttScore)) return ttScore;
+                Move ttMove = hit ? entry.move : Move();
+
+                int staticEval = inCheck ? -INFINITE_SCORE : hit ? entry.eval : evaluate(w);
+
+                if (!pvNode && !inCheck && beta < MATE_BOUND && beta > -MATE_BOUND) {
+                    // reverse futility pruning
+                    if (depth <= m_params.futilityDepth && staticEval - m_params.futilityMargin * depth >= beta) return staticEval;
+
+                    // null move pruning
+                    if (!afterNull && depth >= m_params.nullMoveDepth && staticEval >= beta && hasNonPawnMaterial(b, b.sideToMove())) {
+                        int r = m_params.nullMoveReduction + depth / 6;
+                        Board::Undo u;
+                        b.makeNullMove(u);
+                        int score = -negamax(w, depth - 1 - r, -beta, -beta + 1, ply + 1, false, true);
+                        b.unmakeNullMove(u);
+                        if (stopped(w)) return 0;
+                        if (score >= beta) return score > MATE_BOUND ? beta : score;
+                    }
+                }
+
+                MoveList list;
+                generateMoves(w, list, false);
+                int scores[MoveList::CAPACITY];
+                scoreMoves(w, list, scores, ttMove, ply);
+
+                int bestScore = -INFINITE_SCORE;
+                Move bestMove;
+                int legal = 0;
+                int originalAlpha = alpha;
+                for (int i = 0; i < list.size(); ++i) {
+                    pickMove(list, scores, i);
+                    Move m = list[i];
+                    if (ply == 0 && isExcluded(w, m)) continue;
+                    Board::Undo u;
+                    b.makeMove(m, u);
+                    if (b.leftInCheck()) {
+                        b.unmakeMove(m, u);
+                        continue;
+                    }
+                    ++legal;
+                    bool quiet = !m.isCapture() && !m.isPromotion();
+                    bool givesCheck = b.inCheck();
+                    int newDepth = depth - 1 + (givesCheck ? 1 : 0);
+
+                    int score;
+                    if (legal == 1) {
+                        score = -negamax(w, newDepth, -beta, -alpha, ply + 1, pvNode, false);
+                    } else {
+                        int r = 0;
+                        if (depth >= 3 && legal > m_params.lmrMinMoves && quiet && !inCheck && !givesCheck) {
+                            r = static_cast<int>((m_params.lmrBase + 10000 * std::log(depth) * std::log(legal) / m_params.lmrDivisor) / 100);
+                            if (pvNode) --r;
+                            if (r < 0) r = 0;
+                            if (r > newDepth - 1) r = newDepth - 1 > 0 ? newDepth - 1 : 0;
+                        }
+                        if (r > 0) KS_STAT(w, reductions);
+                        score = -negamax(w, newDepth - r, -alpha - 1, -alpha, ply + 1, false, false);
+                        if (score > alpha && r > 0) {
+                            KS_STAT(w, researches);
+                            score = -negamax(w, newDepth, -alpha - 1, -alpha, ply + 1, false, false);
+                        }
+                        if (score > alpha && score < beta && pvNode) {
+                            KS_STAT(w, researches);
+                            score = -negamax(w, newDepth, -beta, -alpha, ply + 1, true, false);
+                        }
+                    }
+                    b.unmakeMove(m, u);
+                    if (stopped(w)) return 0;
+
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestMove = m;
+                        if (score > alpha) {
+                            alpha = score;
+                            w.pv[ply][ply] = m;
+                            for (int j = ply + 1; j < w.pvLength[ply + 1]; ++j) w.pv[ply][j] = w.pv[ply + 1][j];
+                            w.pvLength[ply] = w.pvLength[ply + 1] > ply + 1 ? w.pvLength[ply + 1] : ply + 1;
+                            if (score >= beta) {
+                                KS_STAT(w, betaCutoffs);
+                                if (legal == 1) KS_STAT(w, firstMoveCutoffs);
+                                if (quiet) {
+                                    if (w.killers[ply][0] != m) {
+                                        w.killers[ply][1] = w.killers[ply][0];
+                                        w.killers[ply][0] = m;
+                                    }
+                                    int& h = w.history[Piece::ColorIndex(b.sideToMove())][m.from()][m.to()];
+                                    h += depth * depth;
+                                    if (h > (1 << 20)) h /= 2;
+                                }
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                if (legal == 0) return inCheck ? -MATE + ply : 0;
+
+                int bound = bestScore >= beta ? TranspositionTable::LOWER : alpha > originalAlpha ? TranspositionTable::EXACT : TranspositionTable::UPPER;
+                // a root search without the best moves must not replace the root entry
+                if (ply > 0 || w.excludedCount == 0)
+                    m_tt.store(b.zobrist(), bestMove, scoreToTT(bestScore, ply), inCheck ? 0 : staticEval, depth, bound);
+                return bestScore;
+            }
+
+            int quiescence(Worker& w, int alpha, int beta, int ply) {
+                Board& b = w.board;
+                countNode(w);
+                KS_STAT(w, qnodes);
+                if (stopped(w)) return 0;
+                if (ply > w.seldepth) w.seldepth = ply;
+                if (ply >= MAX_PLY - 1) return evaluate(w);
+
+                TranspositionTable::Entry entry;
+                bool hit;
+                int ttScore;
+                if (probeCutoff(w, entry, hit, 0, alpha, beta, ply, ttScore)) return ttScore;
+
+                int standPat = evaluate(w);
+                if (standPat >= beta) return standPat;
+                if (standPat > alpha) alpha = standPat;
+
+                MoveList list;
+                generateMoves(w, list, true);
+                int scores[MoveList::CAPACITY];
+                scoreMoves(w, list, scores, hit ? entry.move : Move(), ply);
+
+                int bestScore = standPat;
+                for (int i = 0; i < list.size(); ++i) {
+                    pickMove(list, scores, i);
+                    Move m = list[i];
+                    Board::Undo u;
+                    b.makeMove(m, u);
+                    if (b.leftInCheck()) {
+                        b.unmakeMove(m, u);
+                        continue;
+                    }
+                    int score = -quiescence(w, -beta, -alpha, ply + 1);
+                    b.unmakeMove(m, u);
+                    if (stopped(w)) return 0;
+
+                    if (score > bestScore) {
+                        bestScore = score;
+                        if (score > alpha) {
+                            alpha = score;
+                            if (score >= beta) break;
+                        }
+                    }
+                }
+                return bestScore;
+            }
+
+            TranspositionTable& m_tt; //!shared by all threads and kept between searches
+            int m_threads; //!number of search threads
+            int m_multiPV = 1; //!number of best lines the main thread searches
+            std::vector<SearchInfo> m_lines; //!lines of the last completed iteration, best first
+            SearchParams m_params; //!pruning and reduction constants
+            std::vector<std::unique_ptr<Worker>> m_workers; //!per thread state, index 0 is the main thread
+            SearchLimits m_limits; //!limits of the current search
+            InfoCallback m_onInfo; //!progress callback
+            SearchInfo m_result; //!last completed iteration of the main thread
+            std::atomic<bool> m_stop; //!set to abort every thread
+            std::atomic<bool> m_pondering; //!time limits are ignored while set
+            std::atomic<bool> m_prepared; //!prepare() was called for the next think()
+            TimeManager m_time; //!deadlines of the current search
+    };
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SEARCHSTATS_HH__
+#define SEARCHSTATS_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Search statistics cost a few percent of speed, so release builds (NDEBUG) leave
+// them out entirely unless KS_SEARCH_STATS is set on the command line.
+#ifndef KS_SEARCH_STATS
+#ifdef NDEBUG
+#define KS_SEARCH_STATS 0
+#else
+#define KS_SEARCH_STATS 1
+#endif
+#endif
+
+#if KS_SEARCH_STATS
+#define KS_STAT(worker, counter) (++(worker).stats.counter)
+#define KS_STAT_TIMER(worker, phase) ::KS::SearchStats::Timer statTimer##phase((worker).stats, ::KS::SearchStats::phase)
+#else
+#define KS_STAT(worker, counter) ((void)0)
+#define KS_STAT_TIMER(worker, phase) ((void)0)
+#endif
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Counters and phase timers of one search thread
+     *
+     * Every thread writes only its own block, which fills whole cache lines so the
+     * threads never share one. Search::stats() adds the blocks up on demand.
+     */
+    struct alignas(64) SearchStats {
+        static const bool ENABLED = KS_SEARCH_STATS;
+
+        enum Phase { MOVEGEN, EVAL, SEARCH, PHASES };
+
+        uint64_t nodes = 0;             // every node, filled in when the blocks are added up
+        uint64_t qnodes = 0;            // quiescence nodes
+        uint64_t ttProbes = 0;
+        uint64_t ttHits = 0;
+        uint64_t ttCutoffs = 0;         // nodes answered by the hash table alone
+        uint64_t betaCutoffs = 0;
+        uint64_t firstMoveCutoffs = 0;  // beta cutoffs by the first move searched
+        uint64_t reductions = 0;        // moves searched with a late move reduction
+        uint64_t researches = 0;        // reduced or null window searches that had to be repeated
+        uint64_t cycles[PHASES] = {};   // time stamp counter ticks spent in each phase
+        uint64_t iterationNodes[2] = {};// nodes of all threads after the last two iterations of the main thread
+
+        /**
+         * @brief Add the counters of another thread
+         */
+        void add(const SearchStats& other) {
+            nodes += other.nodes;
+            qnodes += other.qnodes;
+            ttProbes += other.ttProbes;
+            ttHits += other.ttHits;
+            ttCutoffs += other.ttCutoffs;
+            betaCutoffs += other.betaCutoffs;
+            firstMoveCutoffs += other.firstMoveCutoffs;
+            reductions += other.reductions;
+            researches += other.researches;
+            for (int p = 0; p < PHASES; ++p) cycles[p] += other.cycles[p];
+        }
+
+        double ttHitRate() const { return ttProbes ? static_cast<double>(ttHits) / ttProbes : 0; }
+        double firstMoveCutoffRate() const { return betaCutoffs ? static_cast<double>(firstMoveCutoffs) / betaCutoffs : 0; }
+
+        /**
+         * @brief Effective branching factor: growth of the tree from the previous iteration to the last
+         */
+        double branchingFactor() const {
+            return iterationNodes[0] ? static_cast<double>(iterationNodes[1]) / iterationNodes[0] : 0;
+        }
+
+        /**
+         * @brief Share of the search time spent in a phase
+         */
+        double phaseShare(Phase phase) const {
+            return cycles[SEARCH] ? static_cast<double>(cycles[phase]) / cycles[SEARCH] : 0;
+        }
+
+        /**
+         * @brief One line summary for a UCI "info string"
+         */
+        std::string toString() const {
+            std::ostringstream s;
+            s.precision(3);
+            s << "nodes " << nodes << " qnodes " << qnodes << " tthit " << ttHitRate() << " ttcut " << ttCutoffs
+              << " firstcut " << firstMoveCutoffRate() << " reductions " << reductions << " researches " << researches
+              << " ebf " << branchingFactor() << " movegen " << phaseShare(MOVEGEN) << " eval " << phaseShare(EVAL);
+            return s.str();
+        }
+
+        std::string toJson() const {
+            std::ostringstream s;
+            s << "{\"nodes\":" << nodes << ",\"qnodes\":" << qnodes << ",\"tt_probes\":" << ttProbes
+              << ",\"tt_hits\":" << ttHits << ",\"tt_cutoffs\":" << ttCutoffs << ",\"beta_cutoffs\":" << betaCutoffs
+              << ",\"first_move_cutoffs\":" << firstMoveCutoffs << ",\"reductions\":" << reductions
+              << ",\"researches\":" << researches << ",\"ebf\":" << branchingFactor()
+              << ",\"cycles\":{\"movegen\":" << cycles[MOVEGEN] << ",\"eval\":" << cycles[EVAL]
+              << ",\"search\":" << cycles[SEARCH] << "}}";
+            return s.str();
+        }
+
+        /**
+         * @brief Time stamp counter, or steady clock nanoseconds where there is none
+         */
+        static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        /**
+         * @brief Adds the ticks from construction to destruction to one phase
+         */
+        class Timer{
+            public:
+                Timer(SearchStats& stats, Phase phase) : m_stats(stats), m_phase(phase), m_start(now()) {}
+                ~Timer() { m_stats.cycles[m_phase] += now() - m_start; }
+
+            private:
+                SearchStats& m_stats;
+                Phase m_phase;
+                uint64_t m_start;
+        };
+    };
+}
+
+#endif
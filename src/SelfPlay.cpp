@@ -0,0 +1,296 @@
+#include "Board.hh"
+#include "GameClock.hh"
+#include "Search.hh"
+#include "TranspositionTable.hh"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Engine-vs-engine match runner with live Elo and SPRT
+ *
+ * Plays a "test" configuration of the engine against a "base" configuration. Every
+ * game runs on a pool thread with its own boards, searches and hash tables. Each
+ * opening is played twice with colors reversed.
+ *
+ *   SelfPlay [--games N] [--concurrency N] [--tc base+inc] [--increment fischer|bronstein] [--depth N] [--nodes N]
+ *            [--openings file.epd] [--hash MB] [--elo0 E] [--elo1 E] [--alpha A] [--beta B]
+ *            [--base name=value ...] [--test name=value ...]
+ *
+ * name=value pairs set KS::SearchParams fields of one side, e.g. --test lmrDivisor=250.
+ */
+namespace {
+
+    struct Options {
+        int games = 1000;
+        unsigned concurrency = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+        int64_t baseMs = 10000;      // starting clock per side
+        int64_t incMs = 100;         // increment per move
+        KS::GameClock::Mode incMode = KS::GameClock::FISCHER;
+        int depth = 0;               // fixed depth instead of the clock when non-zero
+        uint64_t nodes = 0;          // fixed nodes per move instead of the clock when non-zero
+        size_t hashMb = 8;
+        int maxPlies = 400;          // adjudicate as a draw after this many plies
+        double elo0 = 0, elo1 = 5, alpha = 0.05, beta = 0.05;
+        std::string openingsPath;
+        KS::SearchParams base, test;
+    };
+
+    enum Outcome { TEST_WINS, DRAW, TEST_LOSES };
+
+    /**
+     * @brief Running totals from the test engine's point of view, updated by every pool thread
+     */
+    struct Tally {
+        std::atomic<int> wins{0}, draws{0}, losses{0}, timeLosses{0};
+
+        int games() const { return wins + draws + losses; }
+
+        double score() const {
+            int n = games();
+            return n ? (wins + 0.5 * draws) / n : 0.5;
+        }
+
+        static double eloFromScore(double s) {
+            if (s <= 0) return -1000;
+            if (s >= 1) return 1000;
+            return -400.0 * std::log10(1.0 / s - 1.0);
+        }
+
+        static double scoreFromElo(double elo) {
+            return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+        }
+
+        // variance of a single game's score
+        double variance() const {
+            int n = games();
+            if (!n) return 0;
+            double s = score();
+            return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / n;
+        }
+
+        /** @brief Elo difference and its 95% error margin */
+        void elo(double& diff, double& margin) const {
+            double s = score();
+            double se = games() ? std::sqrt(variance() / games()) : 0;
+            diff = eloFromScore(s);
+            margin = (eloFromScore(s + 1.96 * se) - eloFromScore(s - 1.96 * se)) / 2;
+        }
+
+        /** @brief Log likelihood ratio of H1 (elo1) against H0 (elo0), normal approximation of the trinomial GSPRT */
+        double llr(double elo0, double elo1) const {
+            double var = variance();
+            if (games() < 2 || var <= 0) return 0;
+            double s = score(), s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+            return (s1 - s0) * (2 * s - s0 - s1) * games() / (2 * var);
+        }
+    };
+
+    std::vector<std::string> loadOpenings(const std::string& path) {
+        std::vector<std::string> fens;
+        if (!path.empty()) {
+            std::ifstream in(path);
+            std::string line;
+            KS::Board check;
+            while (std::getline(in, line)) {
+                if (!line.empty() && check.setFen(line)) fens.push_back(line);
+            }
+            if (fens.empty()) std::cerr << "No positions read from " << path << ", using built-in openings" << std::endl;
+        }
+        if (fens.empty()) {
+            const char* lines[] = {
+                "e2e4 e7e5 g1f3 b8c6", "e2e4 c7c5 g1f3 d7d6", "e2e4 e7e6 d2d4 d7d5", "e2e4 c7c6 d2d4 d7d5",
+                "d2d4 d7d5 c2c4 e7e6", "d2d4 g8f6 c2c4 g7g6", "d2d4 g8f6 c2c4 e7e6", "c2c4 e7e5 b1c3 g8f6",
+                "g1f3 d7d5 g2g3 g8f6", "e2e4 d7d6 d2d4 g8f6", "d2d4 d7d5 c2c4 c7c6", "e2e4 e7e5 f1c4 g8f6"};
+            for (const char* line : lines) {
+                KS::Board board;
+                std::istringstream moves(line);
+                std::string text;
+                while (moves >> text) {
+                    KS::Board::Undo u;
+                    board.makeMove(board.parseMove(text), u);
+                }
+                fens.push_back(board.fen());
+            }
+        }
+        return fens;
+    }
+
+    // Play one game, the test engine has white when testWhite is set
+    Outcome playGame(const Options& opt, const std::string& fen, bool testWhite, KS::Search& test, KS::Search& base,
+                     KS::TranspositionTable& testTT, KS::TranspositionTable& baseTT, bool& lostOnTime) {
+        using KS::Piece;
+        testTT.clear();
+        baseTT.clear();
+        KS::Board board(fen);
+        KS::GameClock clock(opt.baseMs, opt.incMs, opt.incMode);
+        bool timed = !opt.depth && !opt.nodes;
+        if (timed) clock.start(board.sideToMove());
+        int testColor = testWhite ? Piece::WHITE : Piece::BLACK;
+        lostOnTime = false;
+
+        auto winner = [&](int color) { return color == testColor ? TEST_WINS : TEST_LOSES; };
+
+        for (int ply = 0; ; ++ply) {
+            int us = board.sideToMove();
+            KS::Board::GameState state = board.gameState();
+            if (state == KS::Board::CHECKMATE) return winner(Piece::Opposite(us));
+            if (state != KS::Board::ONGOING || ply >= opt.maxPlies) return DRAW;
+            KS::MoveList legal;
+            board.generateLegalMoves(legal);
+
+            KS::SearchLimits limits;
+            if (opt.depth || opt.nodes) {
+                limits.depth = opt.depth;
+                limits.nodes = opt.nodes;
+            } else {
+                limits.time[0] = clock.remainingMs(Piece::WHITE);
+                limits.time[1] = clock.remainingMs(Piece::BLACK);
+                limits.inc[0] = limits.inc[1] = opt.incMs;
+            }
+
+            KS::Search& engine = us == testColor ? test : base;
+            KS::Move m = engine.think(board, limits);
+            if (timed) {
+                if (clock.flagged(us)) {
+                    lostOnTime = true;
+                    return winner(Piece::Opposite(us));
+                }
+                clock.press();
+            }
+            if (std::find(legal.begin(), legal.end(), m) == legal.end()) return winner(Piece::Opposite(us));
+
+            KS::Board::Undo u;
+            board.makeMove(m, u);
+        }
+    }
+
+    // The whole of text as a whole number between min and max
+    bool parseNumber(const std::string& text, long min, long max, long& n) {
+        char* end;
+        errno = 0;
+        n = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+    }
+
+    // The whole of text as a number between min and max
+    bool parseReal(const std::string& text, double min, double max, double& x) {
+        char* end;
+        x = std::strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && x >= min && x <= max;
+    }
+
+    bool parseParam(const std::string& text, KS::SearchParams& params) {
+        size_t eq = text.find('=');
+        long value = 0;
+        return eq != std::string::npos && parseNumber(text.substr(eq + 1), INT_MIN, INT_MAX, value) &&
+               params.set(text.substr(0, eq), static_cast<int>(value));
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string flag = argv[i], value = argv[i + 1];
+            long n = 0;
+            if (flag == "--games" && parseNumber(value, 1, 100000000, n)) opt.games = static_cast<int>(n);
+            else if (flag == "--concurrency" && parseNumber(value, 1, 1024, n)) opt.concurrency = static_cast<unsigned>(n);
+            else if (flag == "--tc") {
+                size_t plus = value.find('+');
+                double base = 0, inc = 0;
+                if (!parseReal(value.substr(0, plus), 0, 1e6, base)) return false;
+                if (plus != std::string::npos && !parseReal(value.substr(plus + 1), 0, 1e6, inc)) return false;
+                opt.baseMs = static_cast<int64_t>(base * 1000);
+                opt.incMs = static_cast<int64_t>(inc * 1000);
+            }
+            else if (flag == "--increment" && (value == "fischer" || value == "bronstein"))
+                opt.incMode = value == "fischer" ? KS::GameClock::FISCHER : KS::GameClock::BRONSTEIN;
+            else if (flag == "--depth" && parseNumber(value, 0, KS::Search::MAX_PLY, n)) opt.depth = static_cast<int>(n);
+            else if (flag == "--nodes" && parseNumber(value, 0, LONG_MAX, n)) opt.nodes = static_cast<uint64_t>(n);
+            else if (flag == "--hash" && parseNumber(value, 1, 65536, n)) opt.hashMb = static_cast<size_t>(n);
+            else if (flag == "--openings") opt.openingsPath = value;
+            else if (flag == "--elo0" && parseReal(value, -1000, 1000, opt.elo0)) continue;
+            else if (flag == "--elo1" && parseReal(value, -1000, 1000, opt.elo1)) continue;
+            else if (flag == "--alpha" && parseReal(value, 1e-6, 0.5, opt.alpha)) continue;
+            else if (flag == "--beta" && parseReal(value, 1e-6, 0.5, opt.beta)) continue;
+            else if (flag == "--base" && parseParam(value, opt.base)) continue;
+            else if (flag == "--test" && parseParam(value, opt.test)) continue;
+            else return false;
+        }
+        return argc % 2 == 1;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [--games N] [--concurrency N] [--tc seconds+inc] [--increment fischer|bronstein] [--depth N] [--nodes N]\n"
+                  << "       [--openings file.epd] [--hash MB] [--elo0 E] [--elo1 E] [--alpha A] [--beta B]\n"
+                  << "       [--base name=value] [--test name=value]" << std::endl;
+        return 1;
+    }
+
+    const std::vector<std::string> openings = loadOpenings(opt.openingsPath);
+    const double lower = std::log(opt.beta / (1 - opt.alpha));
+    const double upper = std::log((1 - opt.beta) / opt.alpha);
+
+    Tally tally;
+    std::atomic<int> nextGame(0);
+    std::atomic<bool> finished(false);
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < opt.concurrency; ++t) {
+        pool.emplace_back([&]() {
+            KS::TranspositionTable testTT(opt.hashMb), baseTT(opt.hashMb);
+            KS::Search test(testTT), base(baseTT);
+            test.params() = opt.test;
+            base.params() = opt.base;
+            for (int id = nextGame++; id < opt.games && !finished; id = nextGame++) {
+                bool lostOnTime;
+                Outcome o = playGame(opt, openings[(id / 2) % openings.size()], id % 2 == 0, test, base, testTT, baseTT, lostOnTime);
+                if (lostOnTime) ++tally.timeLosses;
+                if (o == TEST_WINS) ++tally.wins;
+                else if (o == DRAW) ++tally.draws;
+                else ++tally.losses;
+            }
+        });
+    }
+
+    // report once a second until the pool is done or the SPRT reaches a decision
+    int reported = -1;
+    double llr = 0;
+    auto report = [&]() {
+        double diff, margin;
+        tally.elo(diff, margin);
+        llr = tally.llr(opt.elo0, opt.elo1);
+        std::printf("Games %d: +%d =%d -%d  Elo %.1f +/- %.1f  LLR %.2f [%.2f, %.2f]  time losses %d\n",
+                    tally.games(), tally.wins.load(), tally.draws.load(), tally.losses.load(), diff, margin, llr, lower, upper, tally.timeLosses.load());
+        std::fflush(stdout);
+        reported = tally.games();
+    };
+    while (tally.games() < opt.games) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (tally.games() != reported) report();
+        if (llr <= lower || llr >= upper) {
+            finished = true;
+            break;
+        }
+    }
+    for (auto& t : pool) t.join();
+    if (tally.games() != reported) report();
+
+    if (llr >= upper) std::cout << "SPRT: H1 accepted (test is at least " << opt.elo1 << " Elo stronger)" << std::endl;
+    else if (llr <= lower) std::cout << "SPRT: H0 accepted (test is not " << opt.elo1 << " Elo stronger)" << std::endl;
+    else std::cout << "SPRT: inconclusive" << std::endl;
+    return 0;
+}
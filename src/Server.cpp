@@ -0,0 +1,91 @@
+#include "GameServer.hh"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Headless multi-game server, see KS::GameServer for the protocol
+ *
+ *   Server [--port N | --unix PATH] [--io N] [--workers N] [--public]
+ *
+ * Listens on 127.0.0.1:7777 by default; --public listens on all interfaces. --io sets
+ * the number of I/O threads and --workers the number of game threads, half the cores
+ * each by default.
+ * SIGINT or SIGTERM stops it.
+ */
+namespace {
+
+    struct Options {
+        int port = 7777;
+        std::string unixPath;        // listen on this Unix socket instead of TCP
+        unsigned ioThreads = 0;      // 0 for the server's default
+        unsigned workers = 0;
+        bool loopbackOnly = true;
+    };
+
+    KS::GameServer* server = nullptr;
+
+    void onSignal(int) {
+        if (server) server->stop();
+    }
+
+    // The whole of text as a whole number between min and max
+    bool parseNumber(const std::string& text, long min, long max, long& n) {
+        char* end;
+        errno = 0;
+        n = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (flag == "--public") {
+                opt.loopbackOnly = false;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+            long n = 0;
+            if (flag == "--port" && parseNumber(value, 1, 65535, n)) opt.port = static_cast<int>(n);
+            else if (flag == "--unix") opt.unixPath = value;
+            else if (flag == "--io" && parseNumber(value, 0, 256, n)) opt.ioThreads = static_cast<unsigned>(n);
+            else if (flag == "--workers" && parseNumber(value, 0, 256, n)) opt.workers = static_cast<unsigned>(n);
+            else return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [--port N | --unix PATH] [--io N] [--workers N] [--public]" << std::endl;
+        return 1;
+    }
+
+    KS::GameServer games(opt.ioThreads, opt.workers);
+    bool listening = opt.unixPath.empty() ? games.listenTcp(opt.port, opt.loopbackOnly) : games.listenUnix(opt.unixPath);
+    if (!listening) {
+        std::perror("listen");
+        return 1;
+    }
+    server = &games;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::string where = opt.unixPath.empty() ? "port " + std::to_string(opt.port) : opt.unixPath;
+    std::printf("Serving on %s with %u I/O threads and %u game workers\n", where.c_str(), games.ioThreads(), games.workers());
+    std::fflush(stdout);
+    games.run();
+
+    std::printf("Stopped after %llu connections, %llu games, %llu commands\n", static_cast<unsigned long long>(games.connections()),
+                static_cast<unsigned long long>(games.games()), static_cast<unsigned long long>(games.commands()));
+    if (!opt.unixPath.empty()) ::unlink(opt.unixPath.c_str());
+    return 0;
+}
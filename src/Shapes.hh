@@ -26,17 +26,13 @@ namespace AUGL {
      * @brief Override the Widget::draw() method
      * 
      * Draws the shape with the current attributes. 
+     * The window has already cleared the area behind it,
+     * so the hidden box widget is not drawn.
      * The FLTK color state is not permanently changed. 
      * There is no good way to restore the line style. 
      * So it is changed to 1 pt solid.
      */
     void draw() {
-      //first call the base class draw()
-      Widget::draw();
-
-      //ensure proper clearing of the box widget
-      m_widget->draw();
-
       //grab the current color
       //because we are going to restore it
       //after we (potentially) change the color
@@ -64,8 +60,11 @@ namespace AUGL {
      * @brief Move the object by dX horizontally and dY vertically
      */
     virtual void move(int dX, int dY) {
+      //the old and the new place both need drawing
+      redraw();
       m_point.x += dX;
       m_point.y += dY;
+      redraw();
     }
 
   protected:
@@ -0,0 +1,154 @@
+#ifndef SPRITECACHE_HH__
+#define SPRITECACHE_HH__
+
+#include "PieceAtlas.hh"
+#include "Piece.hh"
+#include <FL/Fl.H>
+#include <FL/Fl_Image.H>
+#include <FL/Fl_PNG_Image.H>
+#include <list>
+#include <string>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief The piece images, decoded once and kept scaled for the square sizes in use
+     *
+     * Each square size and screen scale (HiDPI) gets one set, made on first use and
+     * shared by every draw; the board asks for one set per paint and draws from it.
+     * A set is a PieceAtlas rasterized from assets/ChessPiece_Assets.svg (mapped from
+     * its disk cache after the first run) or, if that fails, scaled copies of the twelve
+     * assets/<Piece>_<COLOR>.png files, which are decoded once on first need. Only the
+     * last SIZES sets are kept, so resizing the window evicts the least recently used.
+     * Pieces without any image are left to the board.
+     */
+    class SpriteCache{
+        public:
+            static const int SIZES = 3;
+
+            /**
+             * @brief The images of all pieces for one size, indexed by color index and piece type
+             */
+            struct Set {
+                int size = 0;                   // square size in FLTK units
+                int pixels = 0;                 // square size in screen pixels
+                PieceAtlas* atlas = nullptr;    // all pieces in one image, or null
+                Fl_Image* images[2][8] = {};    // one image per piece when there is no atlas
+
+                Fl_Image* image(int piece) const {
+                    return images[Piece::ColorIndex(Piece::Color(piece))][Piece::PieceType(piece)];
+                }
+
+                /**
+                 * @brief Draw a piece at the upper left corner of its square, false if it has no image
+                 */
+                bool draw(int piece, int x, int y) const {
+                    if (atlas) {
+                        atlas->draw(piece, x, y);
+                        return true;
+                    }
+                    Fl_Image* sprite = image(piece);
+                    if (!sprite) return false;
+                    sprite->draw(x, y);
+                    return true;
+                }
+            };
+
+            explicit SpriteCache(const std::string& directory = "assets") : m_directory(directory), m_decoded(false) {
+                for (auto& color : m_originals) for (Fl_Image*& image : color) image = nullptr;
+            }
+
+            ~SpriteCache() {
+                for (Set& set : m_sets) release(set);
+                for (auto& color : m_originals) for (Fl_Image* image : color) delete image;
+            }
+
+            SpriteCache(const SpriteCache&) = delete;
+            SpriteCache& operator=(const SpriteCache&) = delete;
+
+            /**
+             * @brief The images for a square size, scaled now if the size is not cached
+             */
+            const Set& sprites(int squareSize, float scale = screenScale()) {
+                int pixels = static_cast<int>(squareSize * scale + 0.5f);
+                for (auto it = m_sets.begin(); it != m_sets.end(); ++it) {
+                    if (it->size == squareSize && it->pixels == pixels) {
+                        m_sets.splice(m_sets.begin(), m_sets, it);
+                        return m_sets.front();
+                    }
+                }
+                if (static_cast<int>(m_sets.size()) == SIZES) {
+                    release(m_sets.back());
+                    m_sets.pop_back();
+                }
+                m_sets.emplace_front();
+                Set& set = m_sets.front();
+                set.size = squareSize;
+                set.pixels = pixels;
+                set.atlas = new PieceAtlas();
+                if (set.atlas->load(m_directory + "/ChessPiece_Assets.svg", squareSize, pixels)) return set;
+                delete set.atlas;
+                set.atlas = nullptr;
+
+                decode();
+                for (int c = 0; c < 2; ++c) {
+                    for (int type = 0; type < 8; ++type) {
+                        if (!m_originals[c][type]) continue;
+                        Fl_Image* image = m_originals[c][type]->copy(pixels, pixels);
+#if FL_API_VERSION >= 10400
+                        image->scale(squareSize, squareSize, 0, 1);  // full pixel data, drawn at the square size
+#endif
+                        set.images[c][type] = image;
+                    }
+                }
+                return set;
+            }
+
+            /**
+             * @brief Pixels per FLTK unit on the main screen
+             */
+            static float screenScale() {
+#if FL_API_VERSION >= 10400
+                return Fl::screen_scale(0);
+#else
+                return 1.0f;
+#endif
+            }
+
+        private:
+            void decode() {
+                static const char* const names[8] = {nullptr, "King", "Pawn", "Knight", nullptr, "Bishop", "Rook", "Queen"};
+                static const char* const colors[2] = {"WHITE", "BLACK"};
+                if (m_decoded) return;
+                m_decoded = true;
+                Fl_Image::RGB_scaling(FL_RGB_SCALING_BILINEAR);
+                for (int c = 0; c < 2; ++c) {
+                    for (int type = 0; type < 8; ++type) {
+                        if (!names[type]) continue;
+                        Fl_PNG_Image* png = new Fl_PNG_Image((m_directory + "/" + names[type] + "_" + colors[c] + ".png").c_str());
+                        if (png->fail()) delete png;
+                        else m_originals[c][type] = png;
+                    }
+                }
+            }
+
+            static void release(Set& set) {
+                delete set.atlas;
+                set.atlas = nullptr;
+                for (auto& color : set.images) {
+                    for (Fl_Image*& image : color) {
+                        delete image;
+                        image = nullptr;
+                    }
+                }
+            }
+
+            std::string m_directory; //!where the assets are
+            bool m_decoded; //!the PNG files were decoded
+            Fl_Image* m_originals[2][8]; //!decoded PNG files at their own size
+            std::list<Set> m_sets; //!scaled sets, most recently used first
+    };
+}
+
+#endif
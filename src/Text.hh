@@ -43,8 +43,13 @@ namespace KG{
   };
   class Text : public TextStyle, public AUGL::Shape{
       public:
-      Text(const AUGL::Point& p,const std::string& t) : position(p), text(t) {
-        resize(p.x,p.y,getTextSize(),getTextSize());
+      Text(const AUGL::Point& p,const std::string& t) : position(p), text(t) {}
+
+      void attach(AUGL::Window* window) { // Override for attach(), the box must cover the styled text for redraws
+          m_point = {position.x, position.y - getTextSize()};
+          m_width = getTextSize() * static_cast<int>(text.size());
+          m_height = getTextSize() + getTextSize() / 3;
+          Shape::attach(window);
       }
 
       void drawObject() { // Override for drawObject()
@@ -76,6 +81,10 @@ namespace KG{
         t3.setTextColor(AUGL::Color::BLACK);
         t3.setTextStyle(TextStyle::TIMES_BOLD_ITALIC);
         t3.setTextSize(40);
+
+        attach(t1);
+        attach(t2);
+        attach(t3);
       }
     private:
     Text t1,t2,t3;
@@ -0,0 +1,128 @@
+#ifndef TIMEMANAGER_HH__
+#define TIMEMANAGER_HH__
+
+#include "Move.hh"
+#include "Piece.hh"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace KS{
+
+    /**
+     * @brief What the GUI or caller allows the search to spend, 0 or -1 means unlimited
+     */
+    struct SearchLimits {
+        int depth = 0;              // maximum iteration depth
+        uint64_t nodes = 0;         // node budget over all threads
+        int64_t movetime = 0;       // exact time for this move in milliseconds
+        int64_t time[2] = {-1, -1}; // remaining clock time for white and black in milliseconds
+        int64_t inc[2] = {0, 0};    // increment per move for white and black in milliseconds
+        int movestogo = 0;          // moves until the next time control, 0 for sudden death
+        bool infinite = false;      // search until stop()
+        bool ponder = false;        // search until ponderhit() or stop(), then apply the limits
+    };
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Decides how long one search may take
+     *
+     * The soft deadline is checked between iterations: no new iteration starts once half
+     * of it is used up. It stretches while the best move keeps changing or the score is
+     * falling and shrinks while both are stable. The hard deadline aborts the search and
+     * is checked every CHECK_NODES nodes, which keeps the clock reads out of the node loop.
+     */
+    class TimeManager{
+        public:
+            static const uint64_t CHECK_NODES = 2048;   // power of two
+            static const int64_t OVERHEAD_MS = 30;      // kept back for communication delays
+
+            TimeManager() : m_startNs(0) {}
+
+            /**
+             * @brief Start timing a search for the side to move
+             */
+            void start(const SearchLimits& limits, int side) {
+                m_startNs = nowNs();
+                m_softMs = m_hardMs = 0;
+                m_lastBest = Move();
+                m_changes = 0;
+                m_lastScore = 0;
+                m_scale = 1.0;
+                m_iterations = 0;
+
+                int us = Piece::ColorIndex(side);
+                if (limits.movetime > 0) {
+                    m_softMs = m_hardMs = limits.movetime;
+                    m_fixed = true;
+                } else if (limits.time[us] >= 0) {
+                    int64_t left = limits.time[us] - OVERHEAD_MS > 1 ? limits.time[us] - OVERHEAD_MS : 1;
+                    int movesLeft = limits.movestogo > 0 ? limits.movestogo : 30;
+                    m_softMs = left / movesLeft + limits.inc[us] * 3 / 4;
+                    m_hardMs = m_softMs * 4 < left / 2 ? m_softMs * 4 : left / 2;
+                    if (m_softMs > m_hardMs) m_softMs = m_hardMs;
+                    if (m_hardMs < 1) m_softMs = m_hardMs = 1;
+                    m_fixed = false;
+                }
+            }
+
+            /**
+             * @brief Count from now on, used when a ponder search becomes the real one
+             */
+            void restart() { m_startNs = nowNs(); }
+
+            int64_t elapsedMs() const { return (nowNs() - m_startNs.load()) / 1000000; }
+
+            bool limited() const { return m_hardMs > 0; }
+            int64_t softMs() const { return static_cast<int64_t>(m_softMs * m_scale); }
+            int64_t hardMs() const { return m_hardMs; }
+
+            /**
+             * @brief The search must stop now
+             */
+            bool hardExpired() const { return m_hardMs > 0 && elapsedMs() >= m_hardMs; }
+
+            /**
+             * @brief Report a completed iteration, updating how unstable the search looks
+             */
+            void update(const Move& best, int score) {
+                // best move changes count fully in the iteration they happen and fade by half per iteration
+                m_changes = m_changes / 2 + (m_iterations > 0 && best != m_lastBest ? 1.0 : 0.0);
+                double changeFactor = 0.8 + 0.7 * m_changes;
+                double drop = m_iterations > 0 ? (m_lastScore - score) / 100.0 : 0.0;
+                double scoreFactor = drop > 0 ? 1.0 + (drop < 1.0 ? drop : 1.0) * 0.6 : 1.0;
+                m_scale = changeFactor * scoreFactor;
+                if (m_scale > 2.5) m_scale = 2.5;
+                m_lastBest = best;
+                m_lastScore = score;
+                ++m_iterations;
+            }
+
+            /**
+             * @brief Another iteration would likely not finish in time; never for movetime,
+             *        which uses all of its time and is stopped by the hard limit
+             */
+            bool softExpired() const {
+                if (m_softMs <= 0 || m_fixed) return false;
+                int64_t soft = softMs() < m_hardMs ? softMs() : m_hardMs;
+                return elapsedMs() >= soft / 2;
+            }
+
+        private:
+            static int64_t nowNs() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            std::atomic<int64_t> m_startNs; //!steady clock time the deadlines count from
+            int64_t m_softMs = 0; //!time the move should take before adjustment
+            int64_t m_hardMs = 0; //!abort the search after this many milliseconds
+            bool m_fixed = false; //!movetime: spend exactly the given time
+            Move m_lastBest; //!best move of the previous iteration
+            double m_changes = 0; //!decaying count of best move changes
+            int m_lastScore = 0; //!score of the previous iteration
+            double m_scale = 1.0; //!current stretch of the soft deadline
+            int m_iterations = 0; //!iterations reported so far
+    };
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef TRANSPOSITIONTABLE_HH__
+#define TRANSPOSITIONTABLE_HH__
+
+#include "Move.hh"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Hash table of search results shared by all search threads
+     *
+     * Each slot holds the position key xor'ed with the packed data, so a slot torn by
+     * two threads writing at once fails the key check instead of returning bad data.
+     */
+    class TranspositionTable{
+        public:
+            enum Bound { NONE = 0, UPPER = 1, LOWER = 2, EXACT = 3 };
+
+            struct Entry {
+                Move move;
+                int score;
+                int eval;
+                int depth;
+                int bound;
+            };
+
+            explicit TranspositionTable(size_t megabytes = 16) : m_generation(0) {
+                resize(megabytes);
+            }
+
+            /**
+             * @brief Reallocate to the largest power of two number of slots that fits, clears the table
+             */
+            void resize(size_t megabytes) {
+                size_t slots = 1;
+                while (slots * 2 * sizeof(Slot) <= megabytes * 1024 * 1024) slots *= 2;
+                m_slots = std::vector<Slot>(slots);
+                m_mask = slots - 1;
+                clear();
+            }
+
+            void clear() {
+                for (auto& s : m_slots) {
+                    s.key.store(0, std::memory_order_relaxed);
+                    s.data.store(0, std::memory_order_relaxed);
+                }
+                m_generation = 0;
+            }
+
+            /**
+             * @brief Called once per search so older entries are replaced first
+             */
+            void newSearch() { m_generation = (m_generation + 1) & 0x3f; }
+
+            bool probe(uint64_t key, Entry& entry) const {
+                const Slot& s = m_slots[key & m_mask];
+                uint64_t data = s.data.load(std::memory_order_relaxed);
+                if ((s.key.load(std::memory_order_relaxed) ^ data) != key || data == 0) return false;
+                entry.move = Move::fromRaw(static_cast<uint16_t>(data));
+                entry.score = static_cast<int16_t>(data >> 16);
+                entry.eval = static_cast<int16_t>(data >> 32);
+                entry.depth = static_cast<uint8_t>(data >> 48);
+                entry.bound = static_cast<int>((data >> 56) & 3);
+                return true;
+            }
+
+            void store(uint64_t key, Move move, int score, int eval, int depth, int bound) {
+                Slot& s = m_slots[key & m_mask];
+                uint64_t old = s.data.load(std::memory_order_relaxed);
+                bool sameKey = (s.key.load(std::memory_order_relaxed) ^ old) == key;
+                int oldDepth = static_cast<uint8_t>(old >> 48);
+                int oldGeneration = static_cast<int>(old >> 58);
+                // keep a deeper result of the current search for the same position unless this one is exact
+                if (sameKey && oldGeneration == m_generation && depth < oldDepth && bound != EXACT) return;
+                if (sameKey && move.isNull()) move = Move::fromRaw(static_cast<uint16_t>(old));
+
+                uint64_t data = move.raw()
+                              | static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16
+                              | static_cast<uint64_t>(static_cast<uint16_t>(eval)) << 32
+                              | static_cast<uint64_t>(depth < 0 ? 0 : depth & 0xff) << 48
+                              | static_cast<uint64_t>(bound) << 56
+                              | static_cast<uint64_t>(m_generation) << 58;
+                s.key.store(key ^ data, std::memory_order_relaxed);
+                s.data.store(data, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Permille of sampled slots written during the current search (UCI hashfull)
+             */
+            int hashfull() const {
+                int used = 0;
+                size_t samples = m_slots.size() < 1000 ? m_slots.size() : 1000;
+                for (size_t i = 0; i < samples; ++i) {
+                    uint64_t data = m_slots[i].data.load(std::memory_order_relaxed);
+                    if (data != 0 && static_cast<int>(data >> 58) == m_generation) ++used;
+                }
+                return samples ? static_cast<int>(used * 1000 / samples) : 0;
+            }
+
+        private:
+            struct Slot {
+                std::atomic<uint64_t> key{0};
+                std::atomic<uint64_t> data{0};
+            };
+
+            std::vector<Slot> m_slots; //!the table, a power of two in size
+            size_t m_mask; //!slot count minus one
+            int m_generation; //!6 bit age of the current search
+    };
+}
+
+#endif
@@ -0,0 +1,377 @@
+#include "Board.hh"
+#include "Evaluation.hh"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @authors Kaleb Gebrehiwot and Sofonias Gebre
+ * @brief Texel tuning of the evaluation weights
+ *
+ * Every labelled position is turned into a sparse row of term counts (white minus
+ * black) taken straight from Evaluation::evaluateSide(), so the tuned evaluation is
+ * exactly the one the engine runs. The weights are fitted by minimising the squared
+ * error between the game result and a sigmoid of the evaluation with Adam, and are
+ * written out as a new EvalWeights.hh.
+ *
+ *   Tuner <positions.txt> [--epochs N] [--threads N] [--lr X] [--k K] [--out EvalWeights.hh]
+ *
+ * Each input line is a FEN followed by the game result as "1-0", "0-1", "1/2-1/2" or a
+ * number such as [1.0], [0.5] or 0.0 (white's score). Quiet positions work best.
+ */
+namespace {
+
+    /**
+     * @brief Positions as a structure of arrays; the term counts are stored row by row
+     *        (compressed sparse rows) since a position only uses a few dozen terms
+     */
+    struct Dataset {
+        std::vector<float> result;      // white's score: 1, 0.5 or 0
+        std::vector<float> mgScale;     // phase / MAX_PHASE
+        std::vector<float> egScale;     // 1 - mgScale
+        std::vector<uint32_t> rowStart; // first entry of each position, one extra at the end
+        std::vector<uint16_t> term;     // term index of each entry
+        std::vector<int8_t> count;      // white count minus black count of each entry
+
+        size_t size() const { return result.size(); }
+    };
+
+    bool parseResult(const std::string& line, std::string& fen, float& result) {
+        static const char* markers[] = {"1-0", "0-1", "1/2-1/2"};
+        static const float values[] = {1.0f, 0.0f, 0.5f};
+        for (int i = 0; i < 3; ++i) {
+            size_t at = line.rfind(markers[i]);
+            if (at != std::string::npos && at > 10) {
+                fen = line.substr(0, at);
+                result = values[i];
+                return true;
+            }
+        }
+        // otherwise the last token is a number, possibly in brackets
+        size_t end = line.find_last_not_of(" \t\r]\";");
+        if (end == std::string::npos) return false;
+        size_t begin = line.find_last_of(" \t[\"", end);
+        if (begin == std::string::npos) return false;
+        try {
+            result = std::stof(line.substr(begin + 1, end - begin));
+        } catch (...) {
+            return false;
+        }
+        fen = line.substr(0, begin);
+        return result >= 0.0f && result <= 1.0f;
+    }
+
+    // Append the term counts of one position to a dataset
+    void addPosition(Dataset& data, const KS::Board& board, float result) {
+        int counts[KS::Evaluation::TERMS] = {};
+        for (int color : {KS::Piece::WHITE, KS::Piece::BLACK}) {
+            int sign = color == KS::Piece::WHITE ? 1 : -1;
+            KS::Evaluation::evaluateSide(board, color, [&](int t, int n) { counts[t] += sign * n; });
+        }
+        float phase = static_cast<float>(KS::Evaluation::phase(board)) / KS::Evaluation::MAX_PHASE;
+        data.result.push_back(result);
+        data.mgScale.push_back(phase);
+        data.egScale.push_back(1.0f - phase);
+        for (int t = 0; t < KS::Evaluation::TERMS; ++t) {
+            if (counts[t] == 0) continue;
+            data.term.push_back(static_cast<uint16_t>(t));
+            data.count.push_back(static_cast<int8_t>(std::max(-127, std::min(127, counts[t]))));
+        }
+        data.rowStart.push_back(static_cast<uint32_t>(data.term.size()));
+    }
+
+    // Parse and extract features on every thread, then concatenate the per-thread parts
+    bool load(const std::string& path, unsigned threads, Dataset& data) {
+        std::ifstream in(path);
+        if (!in) return false;
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line); ) {
+            if (!line.empty()) lines.push_back(std::move(line));
+        }
+
+        std::vector<Dataset> parts(threads);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                Dataset& part = parts[t];
+                part.rowStart.push_back(0);
+                KS::Board board;
+                std::string fen;
+                float result;
+                for (size_t i = t; i < lines.size(); i += threads) {
+                    if (parseResult(lines[i], fen, result) && board.setFen(fen)) addPosition(part, board, result);
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+
+        data = Dataset();
+        data.rowStart.push_back(0);
+        for (const Dataset& part : parts) {
+            uint32_t base = data.rowStart.back();
+            data.result.insert(data.result.end(), part.result.begin(), part.result.end());
+            data.mgScale.insert(data.mgScale.end(), part.mgScale.begin(), part.mgScale.end());
+            data.egScale.insert(data.egScale.end(), part.egScale.begin(), part.egScale.end());
+            data.term.insert(data.term.end(), part.term.begin(), part.term.end());
+            data.count.insert(data.count.end(), part.count.begin(), part.count.end());
+            for (size_t i = 1; i < part.rowStart.size(); ++i) data.rowStart.push_back(base + part.rowStart[i]);
+        }
+        return true;
+    }
+
+    // 4 floats processed together; GCC/Clang lower this to SSE or NEON on every 64-bit target
+    typedef float Vec4 __attribute__((vector_size(16)));
+    typedef int32_t IVec4 __attribute__((vector_size(16)));
+    const int LANES = 4;
+
+    // 2^x for |x| < 126 from the exponent bits and a degree 5 polynomial for the fraction
+    inline Vec4 exp2Vec(Vec4 x) {
+        const Vec4 lo = Vec4{} - 126.0f, hi = Vec4{} + 126.0f;
+        x = x < lo ? lo : x;
+        x = x > hi ? hi : x;
+        IVec4 whole = __builtin_convertvector(x, IVec4);
+        whole += (x < __builtin_convertvector(whole, Vec4)); // true is -1: floor for negative x
+        Vec4 f = x - __builtin_convertvector(whole, Vec4);
+        Vec4 p = Vec4{} + 1.8775767e-3f;
+        p = p * f + 8.9893397e-3f;
+        p = p * f + 5.5826318e-2f;
+        p = p * f + 2.4015361e-1f;
+        p = p * f + 6.9315308e-1f;
+        p = p * f + 9.9999994e-1f;
+        IVec4 bits = (whole + 127) << 23;
+        Vec4 scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    /**
+     * @brief Loss kernel over a block of evaluations: adds the squared errors to loss and
+     *        stores d(error^2)/d(eval) / 2 per position in slope
+     */
+    void lossKernel(const float* eval, const float* result, float* slope, size_t n, float k, double& loss) {
+        // sigmoid(e) = 1 / (1 + 10^(-k e / 400)) = 1 / (1 + 2^(-k e log2(10) / 400))
+        const float scale = -k * 3.3219281f / 400.0f;
+        const float dsdx = k * 2.3025851f / 400.0f;
+        Vec4 sum = {};
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            Vec4 e, r;
+            std::memcpy(&e, eval + i, sizeof(e));
+            std::memcpy(&r, result + i, sizeof(r));
+            Vec4 s = 1.0f / (1.0f + exp2Vec(e * scale));
+            Vec4 err = s - r;
+            sum += err * err;
+            Vec4 g = err * s * (1.0f - s) * dsdx;
+            std::memcpy(slope + i, &g, sizeof(g));
+        }
+        for (int l = 0; l < LANES; ++l) loss += sum[l];
+        for (; i < n; ++i) {
+            float s = 1.0f / (1.0f + std::exp2(eval[i] * scale));
+            float err = s - result[i];
+            loss += err * err;
+            slope[i] = err * s * (1.0f - s) * dsdx;
+        }
+    }
+
+    /**
+     * @brief Mean loss over the dataset and, if requested, its gradient for every weight,
+     *        computed in blocks on all threads
+     */
+    double lossAndGradient(const Dataset& data, const std::vector<float>& mg, const std::vector<float>& eg, float k,
+                           unsigned threads, std::vector<double>* gradMg, std::vector<double>* gradEg) {
+        const size_t BLOCK = 4096;
+        std::vector<double> losses(threads, 0.0);
+        std::vector<std::vector<double>> gMg(threads), gEg(threads);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                if (gradMg) {
+                    gMg[t].assign(mg.size(), 0.0);
+                    gEg[t].assign(eg.size(), 0.0);
+                }
+                std::vector<float> eval(BLOCK), slope(BLOCK);
+                size_t per = (data.size() + threads - 1) / threads;
+                size_t first = t * per, last = std::min(data.size(), first + per);
+                for (size_t start = first; start < last; start += BLOCK) {
+                    size_t n = std::min(BLOCK, last - start);
+                    for (size_t i = 0; i < n; ++i) {
+                        size_t p = start + i;
+                        float m = 0, e = 0;
+                        for (uint32_t j = data.rowStart[p]; j < data.rowStart[p + 1]; ++j) {
+                            m += data.count[j] * mg[data.term[j]];
+                            e += data.count[j] * eg[data.term[j]];
+                        }
+                        eval[i] = m * data.mgScale[p] + e * data.egScale[p];
+                    }
+                    lossKernel(eval.data(), &data.result[start], slope.data(), n, k, losses[t]);
+                    if (!gradMg) continue;
+                    for (size_t i = 0; i < n; ++i) {
+                        size_t p = start + i;
+                        double sm = slope[i] * data.mgScale[p], se = slope[i] * data.egScale[p];
+                        for (uint32_t j = data.rowStart[p]; j < data.rowStart[p + 1]; ++j) {
+                            gMg[t][data.term[j]] += sm * data.count[j];
+                            gEg[t][data.term[j]] += se * data.count[j];
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+
+        double loss = 0;
+        for (double l : losses) loss += l;
+        if (gradMg) {
+            gradMg->assign(mg.size(), 0.0);
+            gradEg->assign(eg.size(), 0.0);
+            for (unsigned t = 0; t < threads; ++t) {
+                for (size_t i = 0; i < mg.size(); ++i) {
+                    (*gradMg)[i] += gMg[t][i] / data.size();
+                    (*gradEg)[i] += gEg[t][i] / data.size();
+                }
+            }
+        }
+        return loss / data.size();
+    }
+
+    // Golden section search for the sigmoid scale that fits the current weights best
+    float fitK(const Dataset& data, const std::vector<float>& mg, const std::vector<float>& eg, unsigned threads) {
+        double a = 0.1, b = 3.0;
+        const double ratio = 0.6180339887;
+        for (int i = 0; i < 30; ++i) {
+            double c = b - (b - a) * ratio, d = a + (b - a) * ratio;
+            if (lossAndGradient(data, mg, eg, static_cast<float>(c), threads, nullptr, nullptr)
+                < lossAndGradient(data, mg, eg, static_cast<float>(d), threads, nullptr, nullptr)) b = d;
+            else a = c;
+        }
+        return static_cast<float>((a + b) / 2);
+    }
+
+    void writeTable(std::ostream& out, const std::vector<float>& w) {
+        using KS::Evaluation;
+        static const char* pieceNames[8] = {"", "king", "pawn", "knight", "", "bishop", "rook", "queen"};
+        auto row = [&](int first, int count) {
+            out << "           ";
+            for (int i = first; i < first + count; ++i) out << " " << std::setw(4) << static_cast<int>(std::lround(w[i])) << ",";
+            out << "\n";
+        };
+        out << "            // material by piece type\n";
+        row(Evaluation::MATERIAL, 8);
+        for (int type = 0; type < 8; ++type) {
+            out << "            // piece-square table" << (pieceNames[type][0] ? std::string(": ") + pieceNames[type] : std::string(" (unused)")) << ", A1 first\n";
+            for (int rank = 0; rank < 8; ++rank) row(Evaluation::PST + type * 64 + rank * 8, 8);
+        }
+        out << "            // mobility per attacked square by piece type\n";
+        row(Evaluation::MOBILITY, 8);
+        out << "            // doubled pawn, isolated pawn\n";
+        row(Evaluation::DOUBLED_PAWN, 2);
+        out << "            // passed pawn by relative rank\n";
+        row(Evaluation::PASSED_PAWN, 8);
+        out << "            // bishop pair\n";
+        row(Evaluation::BISHOP_PAIR, 1);
+    }
+
+    bool writeHeader(const std::string& path, const std::vector<float>& mg, const std::vector<float>& eg, size_t positions, double loss) {
+        std::ofstream out(path);
+        out << "// Generated by Tuner from " << positions << " positions (loss " << std::setprecision(6) << loss << ").\n"
+            << "// Regenerate it with the tuner rather than editing it by hand.\n"
+            << "#ifndef EVALWEIGHTS_HH__\n#define EVALWEIGHTS_HH__\n\nnamespace KS{\n\n"
+            << "    /**\n"
+            << "     * @brief Middlegame and endgame weight of every Evaluation term, in Evaluation's term order\n"
+            << "     */\n"
+            << "    struct EvalWeights{\n"
+            << "        static constexpr int MG[] = {\n";
+        writeTable(out, mg);
+        out << "        };\n\n        static constexpr int EG[] = {\n";
+        writeTable(out, eg);
+        out << "        };\n    };\n}\n\n#endif\n";
+        return out.good();
+    }
+
+    // The whole of text as a whole number between min and max
+    bool parseNumber(const std::string& text, long min, long max, long& n) {
+        char* end;
+        errno = 0;
+        n = std::strtol(text.c_str(), &end, 10);
+        return !text.empty() && *end == '\0' && errno == 0 && n >= min && n <= max;
+    }
+
+    // The whole of text as a number between min and max
+    bool parseReal(const std::string& text, double min, double max, double& x) {
+        char* end;
+        x = std::strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && x >= min && x <= max;
+    }
+}
+
+int main(int argc, char** argv) {
+    int epochs = 1000;
+    unsigned threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    double lr = 1.0, fixedK = 0;
+    std::string outPath = "EvalWeights.hh";
+    bool valid = argc >= 2 && argc % 2 == 0;
+    for (int i = 2; valid && i + 1 < argc; i += 2) {
+        std::string flag = argv[i], value = argv[i + 1];
+        long n = 0;
+        if (flag == "--epochs" && parseNumber(value, 0, 10000000, n)) epochs = static_cast<int>(n);
+        else if (flag == "--threads" && parseNumber(value, 1, 1024, n)) threads = static_cast<unsigned>(n);
+        else if (flag == "--lr" && parseReal(value, 1e-9, 1e6, lr)) continue;
+        else if (flag == "--k" && parseReal(value, 0, 100, fixedK)) continue;
+        else if (flag == "--out") outPath = value;
+        else valid = false;
+    }
+    if (!valid) {
+        std::cerr << "Usage: " << argv[0] << " <positions.txt> [--epochs N] [--threads N] [--lr X] [--k K] [--out EvalWeights.hh]" << std::endl;
+        return 1;
+    }
+    float k = static_cast<float>(fixedK);
+
+    Dataset data;
+    if (!load(argv[1], threads, data) || data.size() == 0) {
+        std::cerr << "No labelled positions read from " << argv[1] << std::endl;
+        return 1;
+    }
+    std::cout << "Loaded " << data.size() << " positions, " << data.term.size() << " non-zero terms" << std::endl;
+
+    const KS::Evaluation::Weights& current = KS::Evaluation::weights();
+    std::vector<float> mg(current.mg, current.mg + KS::Evaluation::TERMS);
+    std::vector<float> eg(current.eg, current.eg + KS::Evaluation::TERMS);
+    if (k <= 0) k = fitK(data, mg, eg, threads);
+    std::cout << "K = " << k << ", initial loss " << lossAndGradient(data, mg, eg, k, threads, nullptr, nullptr) << std::endl;
+
+    // Adam
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    std::vector<double> m1(2 * mg.size(), 0.0), m2(2 * mg.size(), 0.0), gMg, gEg;
+    double loss = 0;
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+        loss = lossAndGradient(data, mg, eg, k, threads, &gMg, &gEg);
+        double c1 = 1 - std::pow(beta1, epoch), c2 = 1 - std::pow(beta2, epoch);
+        for (size_t i = 0; i < 2 * mg.size(); ++i) {
+            double g = i < mg.size() ? gMg[i] : gEg[i - mg.size()];
+            m1[i] = beta1 * m1[i] + (1 - beta1) * g;
+            m2[i] = beta2 * m2[i] + (1 - beta2) * g * g;
+            float step = static_cast<float>(lr * (m1[i] / c1) / (std::sqrt(m2[i] / c2) + epsilon));
+            if (i < mg.size()) mg[i] -= step;
+            else eg[i - mg.size()] -= step;
+        }
+        if (epoch % 50 == 0 || epoch == epochs) std::cout << "epoch " << epoch << " loss " << std::setprecision(8) << loss << std::endl;
+    }
+    if (epochs == 0) loss = lossAndGradient(data, mg, eg, k, threads, nullptr, nullptr);
+
+    if (!writeHeader(outPath, mg, eg, data.size(), loss)) {
+        std::cerr << "Cannot write " << outPath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << outPath << std::endl;
+    return 0;
+}
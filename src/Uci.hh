@@ -0,0 +1,221 @@
+#ifndef UCI_HH__
+#define UCI_HH__
+
+#include "Bench.hh"
+#include "Board.hh"
+#include "Notation.hh"
+#include "Search.hh"
+#include "TranspositionTable.hh"
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Universal Chess Interface front end for the engine
+     *
+     * The thread calling loop() only reads and handles input. "go" starts the search
+     * on its own thread, so "stop", "ponderhit" and "isready" are answered right away
+     * while the search runs.
+     */
+    class Uci{
+        public:
+            Uci(std::istream& in = std::cin, std::ostream& out = std::cout)
+                : m_in(in), m_out(out), m_tt(16), m_search(m_tt) {}
+
+            ~Uci() {
+                m_search.stop();
+                waitForSearch();
+            }
+
+            /**
+             * @brief Read and execute commands until "quit" or end of input
+             */
+            void loop() {
+                std::string line;
+                while (std::getline(m_in, line)) {
+                    if (!execute(line)) break;
+                }
+                m_search.stop();
+                waitForSearch();
+            }
+
+            /**
+             * @brief Execute one command line, returns false on "quit"
+             */
+            bool execute(const std::string& line) {
+                std::istringstream words(line);
+                std::string command;
+                words >> command;
+
+                if (command == "uci") {
+                    send("id name KS Chess\n"
+                         "id author Kaleb Gebrehiwot and Sofonias Gebre\n"
+                         "option name Hash type spin default 16 min 1 max 65536\n"
+                         "option name Threads type spin default 1 min 1 max 256\n"
+                         "option name Ponder type check default false\n"
+                         "option name MultiPV type spin default 1 min 1 max 64\n"
+                         "uciok");
+                } else if (command == "isready") {
+                    send("readyok");
+                } else if (command == "ucinewgame") {
+                    waitForSearch();
+                    m_tt.clear();
+                    m_board = Board();
+                } else if (command == "position") {
+                    waitForSearch();
+                    position(words);
+                } else if (command == "setoption") {
+                    waitForSearch();
+                    setOption(words);
+                } else if (command == "go") {
+                    waitForSearch();
+                    go(words);
+                } else if (command == "stop") {
+                    m_search.stop();
+                } else if (command == "ponderhit") {
+                    m_search.ponderhit();
+                } else if (command == "quit") {
+                    return false;
+                } else if (command == "bench") {
+                    waitForSearch();
+                    int depth = Bench::DEFAULT_DEPTH;
+                    words >> depth;
+                    std::ostringstream report;
+                    Bench::run(depth, report);
+                    send(report.str());
+                } else if (command == "d") {
+                    send(m_board.fen());
+                } else if (!command.empty()) {
+                    send("info string unknown command " + command);
+                }
+                return true;
+            }
+
+        private:
+            // Write one or more lines atomically with respect to the search thread
+            void send(const std::string& text) {
+                std::lock_guard<std::mutex> lock(m_outMutex);
+                m_out << text << std::endl;
+            }
+
+            void waitForSearch() {
+                if (m_searchThread.joinable()) m_searchThread.join();
+            }
+
+            // position [startpos | fen <fen>] [moves <move>...]
+            void position(std::istringstream& words) {
+                std::string token, fen;
+                words >> token;
+                if (token == "startpos") {
+                    fen = Board::START_FEN;
+                    words >> token;
+                } else if (token == "fen") {
+                    while (words >> token && token != "moves") fen += token + " ";
+                } else {
+                    return;
+                }
+                if (!m_board.setFen(fen)) {
+                    send("info string invalid fen " + fen);
+                    return;
+                }
+                while (words >> token) {
+                    Move m = Notation::parse(m_board, token);
+                    if (m.isNull()) {
+                        send("info string illegal move " + token);
+                        return;
+                    }
+                    Board::Undo u;
+                    m_board.makeMove(m, u);
+                }
+            }
+
+            // setoption name <name> value <value>
+            void setOption(std::istringstream& words) {
+                std::string token, name, value;
+                words >> token;
+                while (words >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+                words >> value;
+                long n;
+                if (name == "Hash" && spin(value, 1, 65536, n)) {
+                    m_tt.resize(static_cast<size_t>(n));
+                } else if (name == "Threads" && spin(value, 1, 256, n)) {
+                    m_search.setThreads(static_cast<int>(n));
+                } else if (name == "MultiPV" && spin(value, 1, 64, n)) {
+                    m_search.setMultiPV(static_cast<int>(n));
+                } else if (name == "Hash" || name == "Threads" || name == "MultiPV") {
+                    send("info string invalid value " + value + " for " + name);
+                }
+            }
+
+            // A spin option's value clamped to its range, false if it is not a number
+            static bool spin(const std::string& value, long min, long max, long& n) {
+                char* end;
+                errno = 0;
+                n = std::strtol(value.c_str(), &end, 10);
+                if (value.empty() || *end != '\0' || errno == ERANGE) return false;
+                n = n < min ? min : n > max ? max : n;
+                return true;
+            }
+
+            // go [wtime btime winc binc movestogo depth nodes movetime infinite ponder]
+            void go(std::istringstream& words) {
+                SearchLimits limits;
+                std::string token;
+                while (words >> token) {
+                    if (token == "wtime") words >> limits.time[0];
+                    else if (token == "btime") words >> limits.time[1];
+                    else if (token == "winc") words >> limits.inc[0];
+                    else if (token == "binc") words >> limits.inc[1];
+                    else if (token == "movestogo") words >> limits.movestogo;
+                    else if (token == "depth") words >> limits.depth;
+                    else if (token == "nodes") words >> limits.nodes;
+                    else if (token == "movetime") words >> limits.movetime;
+                    else if (token == "infinite") limits.infinite = true;
+                    else if (token == "ponder") limits.ponder = true;
+                }
+
+                Board root = m_board;
+                m_search.prepare(limits.ponder);
+                m_searchThread = std::thread([this, root, limits]() {
+                    Move best = m_search.think(root, limits, [this](const SearchInfo& info) { send(infoString(info, m_search.multiPV() > 1)); });
+                    Move ponder = m_search.ponderMove();
+                    if (SearchStats::ENABLED) send("info string stats " + m_search.stats().toString());
+                    send("bestmove " + best.toString() + (ponder.isNull() ? "" : " ponder " + ponder.toString()));
+                });
+            }
+
+            static std::string infoString(const SearchInfo& info, bool multiPV) {
+                std::ostringstream s;
+                s << "info depth " << info.depth << " seldepth " << info.seldepth;
+                if (multiPV) s << " multipv " << info.multipv;
+                s << " score ";
+                if (Search::isMateScore(info.score)) {
+                    s << "mate " << Search::mateInMoves(info.score);
+                } else {
+                    s << "cp " << info.score;
+                }
+                int64_t ms = info.timeMs > 0 ? info.timeMs : 1;
+                s << " nodes " << info.nodes << " nps " << info.nodes * 1000 / ms << " hashfull " << info.hashfull
+                  << " time " << info.timeMs << " pv";
+                for (const Move& m : info.pv) s << " " << m.toString();
+                return s.str();
+            }
+
+            std::istream& m_in; //!command input
+            std::ostream& m_out; //!response output
+            std::mutex m_outMutex; //!keeps lines from the two threads apart
+            Board m_board; //!position set by the last "position" command
+            TranspositionTable m_tt; //!hash table, kept between moves
+            Search m_search; //!the engine
+            std::thread m_searchThread; //!runs the current "go"
+    };
+}
+
+#endif
@@ -26,7 +26,7 @@ namespace AUGL {
     /**
      * @brief Construct a widget with a point, width, height, label, and callback function
      */
-    Widget(const Point& p, int width, int height, const Text& label, Callback_t callback) : m_point(p), m_width(width), m_height(height), m_label(label), m_callback(callback), m_widget(nullptr), m_owner(nullptr) {
+    Widget(const Point& p, int width, int height, const Text& label, Callback_t callback) : m_point(p), m_width(width), m_height(height), m_label(label), m_callback(callback), m_widget(nullptr), m_owner(nullptr), m_dirty(true) {
     }
 
     /**
@@ -51,6 +51,27 @@ namespace AUGL {
       m_widget->draw();
     }
 
+    /**
+     * @brief Mark the widget to be drawn on the next redraw of its window.
+     *        Defined in Window.hh because it damages the window's area under the widget.
+     */
+    void redraw();
+
+    /**
+     * @brief return true if the widget has to be drawn again,
+     *        either marked by redraw() or damaged by FLTK itself
+     */
+    bool dirty() const { return m_dirty || (m_widget != nullptr && m_widget->damage()); }
+
+    /**
+     * @brief The window drew the widget, clear its damage
+     */
+    void clean() {
+      m_dirty = false;
+      if(m_widget != nullptr)
+	m_widget->clear_damage();
+    }
+
     /**
      * @brief return the x coordinate of the upper left point of the widget
      */
@@ -86,6 +107,7 @@ namespace AUGL {
     Callback_t m_callback; //!the widget's callback function
     Fl_Widget *m_widget; //!a pointer to the hidden Fl_Widget
     Window *m_owner; //!the window that owns the widget
+    bool m_dirty; //!the widget changed since it was last drawn
 
   };
 
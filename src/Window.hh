@@ -5,6 +5,7 @@
 #include "Widget.hh"
 #include <FL/Fl.H>
 #include <FL/Fl_Window.H>
+#include <FL/fl_draw.H>
 #include <string>
 #include <vector>
 
@@ -36,11 +37,23 @@ namespace AUGL {
   protected:
 
     /**
-     * @brief Draw all the widgets attached to this window
+     * @brief Draw the attached widgets that need it
+     *
+     *        FLTK clips drawing to the damaged part of the window. After an expose
+     *        or a Widget::redraw() that part is cleared and every widget over it is
+     *        drawn again. When only FLTK widgets damaged themselves, only they are
+     *        drawn. Widgets outside the clip region are never drawn.
      */
     void draw() {
-      for(auto &w : m_widgets) {
-	w->draw();
+      bool area = damage() & ~FL_DAMAGE_CHILD;
+      if(area) {
+	fl_rectf(0,0,w(),h(),color());
+      }
+      for(auto &widget : m_widgets) {
+	if((area || widget->dirty()) && fl_not_clipped(widget->x(),widget->y(),widget->w(),widget->h())) {
+	  widget->draw();
+	  widget->clean();
+	}
       }
     }
 
@@ -48,6 +61,15 @@ namespace AUGL {
     std::vector<Widget*> m_widgets; //! the list of widgets attached to this window
   };
 
+  /**
+   * @brief Widget::redraw() is defined here because it needs the complete Window
+   */
+  inline void Widget::redraw() {
+    m_dirty = true;
+    if(m_owner != nullptr)
+      m_owner->damage(FL_DAMAGE_USER1,x(),y(),w(),h());
+  }
+
   /**
    * @brief run the event loop
    */
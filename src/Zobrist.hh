@@ -0,0 +1,61 @@
+#ifndef ZOBRIST_HH__
+#define ZOBRIST_HH__
+
+#include <cstdint>
+
+namespace KS{
+
+    /**
+     * @authors Kaleb Gebrehiwot and Sofonias Gebre
+     * @brief Random keys for Zobrist hashing of positions
+     *
+     * The keys come from a fixed seed so a position hashes to the same value in
+     * every run; files that store keys (the game database index) depend on this.
+     */
+    class Zobrist{
+        public:
+            /** @brief key of a Piece (type | color) standing on a square */
+            static uint64_t piece(int piece, int square) { return keys().pieces[piece][square]; }
+
+            /** @brief key toggled when black is to move */
+            static uint64_t side() { return keys().side; }
+
+            /** @brief key of the 4 bit castling rights mask */
+            static uint64_t castling(int rights) { return keys().castling[rights]; }
+
+            /** @brief key of the en passant file */
+            static uint64_t enPassant(int file) { return keys().enPassant[file]; }
+
+        private:
+            struct Keys{
+                uint64_t pieces[32][64]; // indexed directly by the Piece bits, unused slots stay random
+                uint64_t side;
+                uint64_t castling[16];
+                uint64_t enPassant[8];
+
+                Keys() {
+                    uint64_t seed = 0x4B53436865737321ULL;
+                    for (auto& p : pieces)
+                        for (auto& k : p) k = next(seed);
+                    side = next(seed);
+                    for (auto& k : castling) k = next(seed);
+                    for (auto& k : enPassant) k = next(seed);
+                }
+
+                // splitmix64
+                static uint64_t next(uint64_t& state) {
+                    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                    return z ^ (z >> 31);
+                }
+            };
+
+            static const Keys& keys() {
+                static const Keys k;
+                return k;
+            }
+    };
+}
+
+#endif